@@ -1,6 +1,8 @@
 #include "blaster.h"
 #include "SDL2/SDL.h"
+#include "SDL2/SDL_ttf.h"
 #include "game.h"
+#include "memory/alloctracker.h"
 
 #ifdef _WIN32
 #include <time.h>
@@ -9,7 +11,9 @@
 double g_timescale = 1.0;
 
 void parse_arguments(int argc, char *argv[], bool *multiplayer, int *port,
-                     int *host_port, char **host_addr) {
+                     int *host_port, char **host_addr, bool *headless,
+                     int *frame_limit, int *dump_interval,
+                     int *trace_frames) {
     for (int i = 1; i < argc; ++i) {
 
         // Multiplayer mode
@@ -47,6 +51,44 @@ void parse_arguments(int argc, char *argv[], bool *multiplayer, int *port,
             }
         }
 
+        // Offscreen rendering
+        else if (strcmp(argv[i], "-headless") == 0) {
+            *headless = true;
+        }
+
+        // Frame limit
+        else if (strcmp(argv[i], "-frames") == 0) {
+            if (argc > (i + 1)) {
+                int n = atoi(argv[i + 1]);
+                if (n <= 0)
+                    ERROR("Invalid frame limit %d", n);
+                *frame_limit = n;
+                ++i;
+            }
+        }
+
+        // Frame dumps
+        else if (strcmp(argv[i], "-dump") == 0) {
+            if (argc > (i + 1)) {
+                int n = atoi(argv[i + 1]);
+                if (n <= 0)
+                    ERROR("Invalid frame dump interval %d", n);
+                *dump_interval = n;
+                ++i;
+            }
+        }
+
+        // Render trace capture
+        else if (strcmp(argv[i], "-trace") == 0) {
+            if (argc > (i + 1)) {
+                int n = atoi(argv[i + 1]);
+                if (n <= 0)
+                    ERROR("Invalid trace frame count %d", n);
+                *trace_frames = n;
+                ++i;
+            }
+        }
+
         // Help print
         else if (strcmp(argv[i], "-h") == 0) {
             printf("%s", help_str);
@@ -59,13 +101,21 @@ int main(int argc, char *argv[]) {
 
     LOG("Starting Space-Blaster %s", SPACE_BLASTER_VERSION);
 
+    // Memory hooks have to be in place before SDL allocates anything
+    AllocTracker::install();
+
     // Default values for arguments
     bool multiplayer = false;
     int port = DEFAULT_PORT;
     int host_port = DEFAULT_PORT;
     char *host_addr = nullptr;
+    bool headless = false;
+    int frame_limit = 0;
+    int dump_interval = 0;
+    int trace_frames = 0;
 
-    parse_arguments(argc, argv, &multiplayer, &port, &host_port, &host_addr);
+    parse_arguments(argc, argv, &multiplayer, &port, &host_port, &host_addr,
+                    &headless, &frame_limit, &dump_interval, &trace_frames);
 
     // Initialize truetype fonts
     if (TTF_Init() == -1)
@@ -75,7 +125,11 @@ int main(int argc, char *argv[]) {
     Game::Ptr game =
         Game::Ptr(new Game(multiplayer, port, host_port, host_addr));
     game->configure("options.ini");
+    game->headless = headless;
+    game->dump_interval = dump_interval;
     game->init();
+    if (trace_frames > 0)
+        game->renderEngine.startTrace("render_trace.bin", trace_frames);
 
     // Exit flag
     bool quit = false;
@@ -98,15 +152,23 @@ int main(int argc, char *argv[]) {
     Uint32 last_step = SDL_GetTicks();
     Uint32 delta = 0;
 
+    // Frame timing for -frames
+    int frames = 0;
+    Uint64 frame_ticks = 0;
+
     while (!quit) {
 
         // Record current time
         Uint32 frame_start = SDL_GetTicks();
+        Uint64 frame_counter_start = SDL_GetPerformanceCounter();
 
-        // Record delta time for the frame and adjust timescale accordingly
+        // Record delta time for the frame and adjust timescale accordingly.
+        // Headless runs use a fixed timestep so that runs are comparable
+        // no matter how fast frames are rendered.
         delta = frame_start - last_step;
-        g_timescale =
-            static_cast<double>(delta) / static_cast<double>(TICKS_PER_FRAME);
+        g_timescale = headless ? 1.0
+                               : static_cast<double>(delta) /
+                                     static_cast<double>(TICKS_PER_FRAME);
 
         // Run input updates
         while (SDL_PollEvent(&e) != 0) {
@@ -115,16 +177,28 @@ int main(int argc, char *argv[]) {
                                          (e.key.keysym.sym == SDLK_ESCAPE))) {
                 quit = true;
             }
+
+            // Capture the upcoming frames for offline replay
+            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F9 &&
+                !e.key.repeat) {
+                std::string path =
+                    "render_trace_" + std::to_string(SDL_GetTicks()) + ".bin";
+                game->renderEngine.startTrace(path, RENDER_TRACE_FRAMES);
+            }
         }
 
         // Run game for one tick forward
         game->advance();
         last_step = frame_start;
 
+        frame_ticks += SDL_GetPerformanceCounter() - frame_counter_start;
+        if (frame_limit > 0 && ++frames >= frame_limit)
+            quit = true;
+
 #if CAP_FPS
-        // Cap at max fps
+        // Cap at max fps, headless runs go as fast as possible
         Uint32 frame_end = SDL_GetTicks();
-        if ((frame_end - frame_start) < TICKS_PER_MAX_FPS) {
+        if (!headless && (frame_end - frame_start) < TICKS_PER_MAX_FPS) {
             SDL_Delay(TICKS_PER_MAX_FPS - (frame_end - frame_start));
         }
 #endif
@@ -133,7 +207,17 @@ int main(int argc, char *argv[]) {
         // LOG("Delta %d Timescale %f", delta, timescale);
         perfText->setText("FPS: " + std::to_string((1 / g_timescale) * 60));
 #endif
+
+        AllocTracker::endFrame();
+    }
+
+    if (frames > 0) {
+        double ms = static_cast<double>(frame_ticks) * 1000.0 /
+                    static_cast<double>(SDL_GetPerformanceFrequency());
+        LOG("%d frames in %.1f ms, %.3f ms per frame", frames, ms,
+            ms / frames);
     }
 
+    AllocTracker::shutdown();
     return EXIT_SUCCESS;
 }
@@ -25,6 +25,12 @@ Optional arguments:
                     Pass only if you wish to play multiplayer as a slave.
     -hp <port>,     Set host UDP port.
                     Pass only if you wish to play multiplayer as a slave.
+    -headless,      Render offscreen with the software renderer, without a
+                    window or display. Runs at a fixed timestep.
+    -frames <n>,    Quit after n frames and log the average frame time
+    -dump <n>,      Save every nth presented frame as frame_<number>.bmp
+    -trace <n>,     Capture the draw commands of the first n frames to
+                    render_trace.bin, F9 captures the next frames in game
     -h,             Print this help
 )HELP";
 
@@ -49,6 +55,10 @@ static const double DEG2RAD = 1.0 / RAD2DEG;
 // Threading
 #define BLASTER_MULTITHREAD 0
 
+// Worker threads for the particle update, -1 uses all but one hardware
+// thread and 0 updates particles on the game thread
+#define PARTICLE_WORKERS -1
+
 // Networking
 #define DEFAULT_PORT 2000
 #define PACKET_SIZE 1024
@@ -59,6 +69,47 @@ static const double DEG2RAD = 1.0 / RAD2DEG;
 // Enable performance logging
 #define SHOW_FPS 1
 
+// Track heap allocations per subsystem, see memory/alloctracker.h
+#define TRACK_ALLOCATIONS 0
+#define ALLOC_REPORT_INTERVAL 300
+
+// Periodically log deferred destruction statistics, see game/graveyard.h
+#define DEBUG_GRAVEYARD 0
+#define GRAVEYARD_REPORT_INTERVAL 300
+
+// Periodically log particle budget decisions, see game/particlebudget.h
+#define DEBUG_PARTICLE_BUDGET 0
+#define PARTICLE_BUDGET_REPORT_INTERVAL 300
+
+// Periodically log spawn queue depth, see game/spawnqueue.h
+#define DEBUG_SPAWN_QUEUE 0
+#define SPAWN_QUEUE_REPORT_INTERVAL 300
+
+// Draw and present frames on a dedicated render thread. SDL only guarantees
+// rendering from the main thread, so this is not supported on all platforms.
+#define RENDER_THREAD 0
+
+// Frames captured by F9 to a render trace, see rendering/rendertrace.h
+#define RENDER_TRACE_FRAMES 300
+
+// Log render command counts, see rendering/rendercommandbuffer.h
+#define DEBUG_RENDER_BATCHING 0
+#define RENDER_BATCHING_REPORT_INTERVAL 300
+
+// Log dynamic resolution scale changes, see rendering/resolutionscaler.h
+#define DEBUG_DYNAMIC_RESOLUTION 0
+
+// Log vertices saved by polygon level of detail, see rendering/polygonlod.h
+#define DEBUG_POLYGON_LOD 0
+#define POLYGON_LOD_REPORT_INTERVAL 300
+
+// Objects this far outside of the screen are still rendered
+#define VIEW_CULL_MARGIN 8
+
+// Log rendered and culled object counts
+#define DEBUG_VIEW_CULLING 0
+#define VIEW_CULLING_REPORT_INTERVAL 300
+
 // Cap at MAX_FPS
 #define CAP_FPS 1
 
@@ -82,6 +133,10 @@ static const double DEG2RAD = 1.0 / RAD2DEG;
 #define N_RENDER_LAYERS 8
 #define TOP_RENDER_LAYER_IDX (N_RENDER_LAYERS - 1)
 #define BOTTOM_RENDER_LAYER_IDX 0
+// Text and other overlays, drawn at native resolution on top of the world
+#define HUD_RENDER_LAYER_IDX TOP_RENDER_LAYER_IDX
+// Topmost layer of the game world
+#define WORLD_TOP_RENDER_LAYER_IDX (HUD_RENDER_LAYER_IDX - 1)
 
 // ------ Macros ------ //
 #define FILENAME                                                               \
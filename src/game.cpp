@@ -1,6 +1,10 @@
 #include "game.h"
 #include "config/INIReader.h"
 #include "game/collisionutils.h"
+#include "game/graveyard.h"
+#include "rendering/polygonlod.h"
+#include "game/spawnqueue.h"
+#include "memory/alloctracker.h"
 #include <memory>
 #include <utility>
 
@@ -12,6 +16,7 @@
 GameState Game::gameState;
 SDL_Window *Game::WINDOW = nullptr;
 SDL_Renderer *Game::RENDERER = nullptr;
+SDL_Surface *Game::FRAMEBUFFER = nullptr;
 Viewport *Game::VIEWPORT = nullptr;
 
 Game::Game(bool multiplayer, int port, int host_port, char *host_address) {
@@ -32,14 +37,25 @@ Game::Game(bool multiplayer, int port, int host_port, char *host_address) {
 }
 
 Game::~Game() {
-    SDL_DestroyWindow(Game::WINDOW);
+    // Buried and queued objects still reference objects owned by the game
+    g_spawn_queue.clear();
+    g_graveyard.flush();
+    renderEngine.stopThread();
+    // No frame follows to flush the tasks of the last one, e.g. its dump
+    renderEngine.runPendingTasks(Game::RENDERER);
     SDL_DestroyRenderer(Game::RENDERER);
+    if (Game::WINDOW)
+        SDL_DestroyWindow(Game::WINDOW);
+    if (Game::FRAMEBUFFER)
+        SDL_FreeSurface(Game::FRAMEBUFFER);
     SDL_Quit();
 }
 
 void Game::init() {
     // Initialize video context
     initVideo_();
+    if (software_rasterizer)
+        renderEngine.enableRasterizer();
 
     // Initialize keyboard handler
     key_states = SDL_GetKeyboardState(nullptr);
@@ -48,12 +64,18 @@ void Game::init() {
 
     // Initialize text content
     initText_();
+    minimap_.reset(new Minimap(&renderEngine));
     gameState = ON;
+
+#if RENDER_THREAD
+    // The renderer belongs to the render thread from here on
+    renderEngine.startThread(Game::RENDERER);
+#endif
 }
 
 void Game::initializeGameObjects_() {
     if (!multiplayer_) {
-        particles.reset(new ParticleHandler(&physicsEngine, &renderEngine));
+        particles.reset(new ParticleHandler(&renderEngine));
         asteroids.reset(new AsteroidHandler(&physicsEngine, &renderEngine,
                                             particles.get()));
         ship.reset(new Ship(&physicsEngine, &renderEngine,
@@ -89,7 +111,7 @@ void Game::initText_() {
     gameOverText_.reset(new TextEngine(&renderEngine));
     gameOverText_->setFontSize(50);
     gameOverText_->setPosition(SCREEN_RES_W / 3 - 200, SCREEN_RES_H / 3);
-    gameOverText_->setColor(200, 0, 0, 0);
+    gameOverText_->setColor(200, 0, 0, 255);
     gameOverText_->setText("");
 
     // Initialize ship info text renders
@@ -116,6 +138,10 @@ void Game::initText_() {
 }
 
 void Game::initVideo_() {
+    if (headless) {
+        initHeadlessVideo_();
+        return;
+    }
 
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0)
@@ -159,11 +185,66 @@ void Game::initVideo_() {
     if (SDL_RenderSetScale(Game::RENDERER, w_scale, h_scale) < 0)
         ERROR("SDL render scale failed: %s", SDL_GetError());
 
+    render_scale_ = w_scale;
+    if (dynamic_resolution)
+        resolution.init(Game::RENDERER, renderEngine.getCommandBuffer(),
+                        w_scale, h_scale);
+
     // Initialize renderer color
     SDL_SetRenderDrawColor(Game::RENDERER, 0xFF, 0xFF, 0xFF, 0xFF);
     SDL_SetRenderDrawBlendMode(Game::RENDERER, SDL_BLENDMODE_NONE);
 }
 
+void Game::initHeadlessVideo_() {
+    // The dummy driver needs no display, it has to be picked before SDL_Init
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+        ERROR("SDL could not initialize! SDL Error: %s", SDL_GetError());
+
+    Game::FRAMEBUFFER = SDL_CreateRGBSurfaceWithFormat(
+        0, w_requested, h_requested, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (Game::FRAMEBUFFER == nullptr)
+        ERROR("Framebuffer could not be created! SDL Error: %s",
+              SDL_GetError());
+
+    Game::RENDERER = SDL_CreateSoftwareRenderer(Game::FRAMEBUFFER);
+    if (Game::RENDERER == nullptr)
+        ERROR("Renderer could not be created! SDL Error: %s", SDL_GetError());
+    LOG("Rendering offscreen at %dx%d", w_requested, h_requested);
+
+    double w_scale = (double)w_requested / (double)SCREEN_RES_W;
+    double h_scale = (double)h_requested / (double)SCREEN_RES_H;
+    LOG("Render scaling factors: %f %f", w_scale, h_scale);
+    if (SDL_RenderSetScale(Game::RENDERER, w_scale, h_scale) < 0)
+        ERROR("SDL render scale failed: %s", SDL_GetError());
+
+    render_scale_ = w_scale;
+    if (dynamic_resolution)
+        resolution.init(Game::RENDERER, renderEngine.getCommandBuffer(),
+                        w_scale, h_scale);
+
+    SDL_SetRenderDrawColor(Game::RENDERER, 0xFF, 0xFF, 0xFF, 0xFF);
+    SDL_SetRenderDrawBlendMode(Game::RENDERER, SDL_BLENDMODE_NONE);
+}
+
+void Game::dumpFrame_() {
+    unsigned int frame = frames_presented_++;
+    if (dump_interval <= 0 || Game::FRAMEBUFFER == nullptr ||
+        frame % dump_interval != 0)
+        return;
+
+    // Runs before the next frame is drawn, when the framebuffer still holds
+    // this one. Also correct with a render thread owning the framebuffer.
+    SDL_Surface *framebuffer = Game::FRAMEBUFFER;
+    renderEngine.getCommandBuffer().defer(
+        [framebuffer, frame](SDL_Renderer *) {
+            char path[32];
+            snprintf(path, sizeof(path), "frame_%05u.bmp", frame);
+            if (SDL_SaveBMP(framebuffer, path) < 0)
+                LOG("Saving %s failed: %s", path, SDL_GetError());
+        });
+}
+
 void Game::configure(std::string conf) {
     INIReader config(std::move(conf));
     if (config.ParseError() != 0)
@@ -174,9 +255,24 @@ void Game::configure(std::string conf) {
     h_requested = static_cast<int>(config.GetInteger("game", "height", 720));
     fancy_graphics = config.GetBoolean("game", "fancyGraphics", false);
     vsync = config.GetBoolean("game", "vsync", true);
+    g_polygon_lod.setQuality(static_cast<PolygonLod::Quality>(config.GetInteger(
+        "game", "renderQuality", PolygonLod::QUALITY_MEDIUM)));
+    dynamic_resolution =
+        config.GetBoolean("game", "dynamicResolution", false);
+    software_rasterizer =
+        config.GetBoolean("game", "softwareRasterizer", false);
+    resolution.configure(config.GetReal("game", "minRenderScale", 0.5),
+                         config.GetReal("game", "maxRenderScale", 1.0),
+                         config.GetReal("game", "targetFrameTime",
+                                        TICKS_PER_FRAME));
 }
 
 void Game::advance() {
+    Uint64 advance_start = SDL_GetPerformanceCounter();
+
+    // Release all per-tick temporaries of the previous frame
+    g_frame_arena.reset();
+
     if (!ship->alive)
         gameState = ENDED;
 
@@ -188,31 +284,54 @@ void Game::advance() {
             messageHandler->buildShipMessage(ship.get());
         // socket->send(shipMessage.GetBufferPointer(), shipMessage.GetSize());
     }
+
+    // Tear down objects that died during the tick
+    g_graveyard.flush();
+
+    // Presenting may block on vsync or on the render thread, which is not
+    // frame work
+    Uint64 work = SDL_GetPerformanceCounter() - advance_start - present_ticks_;
+    frame_work_ms_ = static_cast<double>(work) * 1000.0 /
+                     static_cast<double>(SDL_GetPerformanceFrequency());
+    resolution.update(frame_work_ms_);
 }
 
 void Game::advanceSingleplayer_() {
+    // Let the particle budget react to the cost of the previous tick
+    particles->getBudget().beginFrame(frame_work_ms_, particles->size());
+
     if (gameState == ON) {
         gameOn_();
     } else if (gameState == ENDED) {
         gameOver_();
     }
 
-    checkInView_();
     runCollisions_();
 
     if (ship->isDamageTaken()) {
-        SDL_SetRenderDrawColor(Game::RENDERER, 0x50, 0x00, 0x10, 0x00);
+        renderEngine.getCommandBuffer().setClearColor(
+            SDL_Color{0x50, 0x00, 0x10, 0x00});
         crash = false;
     } else {
-        SDL_SetRenderDrawColor(Game::RENDERER, 0x00, 0x00, 0x10, 0x00);
+        renderEngine.getCommandBuffer().setClearColor(
+            SDL_Color{0x00, 0x00, 0x10, 0x00});
     }
-    SDL_RenderClear(Game::RENDERER);
+    resolution.apply(renderEngine.getCommandBuffer());
+    g_polygon_lod.setPixelScale(render_scale_ * resolution.getScale());
+
+    // Materialize queued bursts before the update tasks
+    g_spawn_queue.update();
 
     // Run update tasks
     particles->update();
     asteroids->update();
     camperPunisher->update();
     bullets.update();
+    {
+        auto entities = Entity::getEntities();
+        checkInView_(entities);
+        minimap_->update(entities);
+    }
     renderEngine.render();
     ship->update();
 
@@ -221,13 +340,18 @@ void Game::advanceSingleplayer_() {
     viewport.update();
 
     // Render everything onto screen
-    // SDL_RenderSetViewport(Game::RENDERER, viewport.get());
-    SDL_RenderPresent(Game::RENDERER);
+    {
+        ALLOC_SCOPE(ALLOC_RENDERING);
+        renderEngine.present(Game::RENDERER);
+        present_ticks_ = renderEngine.getPresentTicks();
+        dumpFrame_();
+    }
 
     // Advance a step in the physics engine.
     // This executes all forces/actions stored to the physics objects, and
     // calculates the new physics of the object for the next frame.
-    physicsEngine.step();
+    physicsEngine.step(PHYSICS_VISUAL_DEBUG ? &renderEngine.getCommandBuffer()
+                                            : nullptr);
 
     // Update text elements
     updateTextContent_();
@@ -243,6 +367,8 @@ void Game::gameOver_() {
             gameOverText_->setText("");
             livesInfo_->setColor(255, 255, 255, 255);
             space_hold_ = 0;
+            // Fragments queued by the last game must not spawn into this one
+            g_spawn_queue.clear();
             asteroids->resetAsteroids();
             ship->reset(300, 300, -90);
             gameState = ON;
@@ -252,7 +378,7 @@ void Game::gameOver_() {
         space_hold_ = 0;
     }
     unsigned int t = ship->getTimeAlive();
-    gameOverText_->setText("You survived " + std::to_string(t) +
+    gameOverText_->setText(FrameString("You survived ") + toFrameString(t) +
                            " seconds. Hold space to restart");
 }
 
@@ -270,22 +396,31 @@ void Game::gameOn_() {
 }
 
 void Game::updateTextContent_() {
-    timeInfo_->setText("Time: " + std::to_string(ship->getTimeAlive()));
-    if (!ship->getActiveWeapon()->isReloading()) {
+    ALLOC_SCOPE(ALLOC_TEXT);
+
+    // Strings are built in the frame arena to keep the HUD allocation free
+    timeInfo_->setText(FrameString("Time: ") +
+                       toFrameString(ship->getTimeAlive()));
+
+    Weapon *weapon = ship->getActiveWeapon();
+    FrameString magazine(weapon->getName().c_str());
+    if (!weapon->isReloading()) {
         magazineInfo_->setColor(255, 255, 255, 255);
-        magazineInfo_->setText(ship->getActiveWeapon()->getName() + ": " +
-                               std::to_string(ship->getActiveWeapon()->getShotsLeft()));
+        magazine += ": ";
+        magazine += toFrameString(weapon->getShotsLeft());
     } else {
         magazineInfo_->setColor(255, 0, 0, 255);
-        magazineInfo_->setText(ship->getActiveWeapon()->getName() + " reloading");
+        magazine += " reloading";
     }
+    magazineInfo_->setText(magazine);
 
     if (ship->getLives() == 1) {
         livesInfo_->setColor(255, 0, 0, 255);
     }
 
-    livesInfo_->setText("HP: " + std::to_string(ship->getLives()));
-    scoreInfo_->setText("Score: " + std::to_string(ship->getScore()));
+    livesInfo_->setText(FrameString("HP: ") + toFrameString(ship->getLives()));
+    scoreInfo_->setText(FrameString("Score: ") +
+                        toFrameString(ship->getScore()));
 }
 
 void Game::handleInput_() {
@@ -334,13 +469,13 @@ void Game::handleInput_() {
 }
 
 
-void Game::checkInView_() {
-    auto entities = Entity::getEntities();
-    for (auto & e : entities) {
+void Game::checkInView_(const FrameEntityList &entities) {
+    for (auto &e : entities) {
         if (auto b = e->getBody()) {
-            // TODO
+            b->setInView(viewport.isRectInView(b->getMinX(), b->getMinY(),
+                                               b->getMaxX(), b->getMaxY(),
+                                               VIEW_CULL_MARGIN));
         }
-
     }
 }
 
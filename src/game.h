@@ -8,15 +8,18 @@ class PhysicsEngine;
 #include "game/asteroidHandler.h"
 #include "game/background.h"
 #include "game/bullethandler.h"
+#include "game/minimap.h"
 #include "game/particleHandler.h"
 #include "game/ship.h"
 #include "game/textEngine.h"
 #include "game/viewport.h"
 #include "game/CamperPunisher.h"
+#include "memory/framearena.h"
 #include "messaging/messagehandler.h"
 #include "networking/socket.h"
 #include "physics/physicsengine.h"
 #include "rendering/renderengine.h"
+#include "rendering/resolutionscaler.h"
 #include <memory>
 
 ///
@@ -53,6 +56,8 @@ class Game {
     static GameState gameState;
     static SDL_Window *WINDOW;
     static SDL_Renderer *RENDERER;
+    // Offscreen render target of headless runs, nullptr with a window
+    static SDL_Surface *FRAMEBUFFER;
     static Viewport *VIEWPORT;
 
     // Viewport tracking
@@ -64,6 +69,9 @@ class Game {
     // Render engine handling all renderable objects
     RenderEngine renderEngine = RenderEngine(&viewport);
 
+    // Frame-time driven world resolution
+    ResolutionScaler resolution;
+
     // Main ship
     Ship::Ptr ship;
 
@@ -74,7 +82,7 @@ class Game {
     AsteroidHandler::Ptr asteroids;
 
     // Bullet handling
-    BulletHandler bullets;
+    BulletHandler bullets = BulletHandler(&physicsEngine, &renderEngine);
 
     // Particle handling
     ParticleHandler::Ptr particles;
@@ -103,11 +111,27 @@ class Game {
     bool vsync;
     int h_requested;
     int w_requested;
+    bool dynamic_resolution;
+    bool software_rasterizer;
+
+    // Render offscreen with the software renderer and the dummy video
+    // driver, no window or display is needed
+    bool headless = false;
+    // Save every nth presented frame as a bitmap, 0 disables
+    int dump_interval = 0;
 
   private:
     int port_;
     int host_port_;
     unsigned int space_hold_ = 0;
+
+    // Render scale of the screen, screen pixels per game coordinate unit
+    double render_scale_ = 1.0;
+
+    // Duration of the last tick excluding presenting, in ms
+    double frame_work_ms_ = 0.0;
+    Uint64 present_ticks_ = 0;
+    unsigned int frames_presented_ = 0;
     char *host_address_;
     bool multiplayer_;
     MultiplayerRole multiplayerRole_;
@@ -119,6 +143,9 @@ class Game {
     TextEngine::Ptr gameOverText_;
     TextEngine::Ptr scoreInfo_;
 
+    // Overview of the whole game area
+    Minimap::Ptr minimap_;
+
     int ship_x_pos = 300;
     int ship_y_pos = 300;
     int ship_orientation = -90;
@@ -165,6 +192,16 @@ class Game {
     ///
     void initVideo_();
 
+    ///
+    /// \brief Initializes the offscreen renderer of headless runs
+    ///
+    void initHeadlessVideo_();
+
+    ///
+    /// \brief Saves the frame just presented if it is due for dumping
+    ///
+    void dumpFrame_();
+
     ///
     /// \brief Updates text elements on the UI
     ///
@@ -173,7 +210,12 @@ class Game {
     /// \brief run all collision detections
     static void runCollisions_();
 
-    void checkInView_();
+    ///
+    /// \brief Marks entity bodies outside of the viewport so that the
+    /// render engine skips them
+    /// \param entities active entities of this frame
+    ///
+    void checkInView_(const FrameEntityList &entities);
 };
 
 #endif // GAME_H
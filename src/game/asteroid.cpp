@@ -92,10 +92,10 @@ void Asteroid::update() {
     screenPos = body.getScreenPosition();
 
 #if DEBUG_ASTEROID_BORDERS
-    int X = body->getMaxX();
-
-    SDL_SetRenderDrawColor(Game::RENDERER, 255,0,0,255);
-    SDL_RenderDrawLine(Game::RENDERER, X, 0, X, 7000);
+    int X = body.getMaxX();
+    SDL_Point border[2] = {{X, 0}, {X, GAME_AREA_HEIGHT}};
+    renderEngine_->getCommandBuffer().drawLines(
+        WORLD_TOP_RENDER_LAYER_IDX, SDL_Color{255, 0, 0, 255}, border, 2);
 #endif
 
     // Check if asteroid is out of bounds
@@ -106,6 +106,12 @@ void Asteroid::update() {
 }
 
 void Asteroid::markDead() { alive_ = false; }
+
+void Asteroid::retire() {
+    setCollidable(false);
+    body.setRendering(false);
+    markForRemoval();
+}
 void Asteroid::markSplit() { split_ = true; }
 bool Asteroid::isAlive() { return alive_; }
 bool Asteroid::isDueSplit() { return split_; }
@@ -36,6 +36,12 @@ class Asteroid : public PhysicsObject, public Entity {
     void update();
 
     void markDead();
+
+    ///
+    /// \brief Makes the asteroid inert ahead of its deferred destruction:
+    /// disables rendering and collisions and marks the entity for removal
+    ///
+    void retire();
     void markSplit();
     bool isAlive();
     bool isDueSplit();
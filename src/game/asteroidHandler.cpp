@@ -1,10 +1,15 @@
 #include "asteroidHandler.h"
 #include "coordinateutils.h"
+#include "graveyard.h"
+#include "spawnqueue.h"
 #include "rng.h"
 #include "../blaster.h"
 #include "../game.h"
+#include "../memory/alloctracker.h"
+#include "../memory/framearena.h"
 
 #include <iostream>
+#include <iterator>
 
 #ifdef _WIN32
 #include <math.h>
@@ -200,28 +205,38 @@ void AsteroidHandler::splitAsteroid_(Asteroid *asteroid) {
 }
 
 void AsteroidHandler::updateAsteroids_() {
-    // Delete asteroid object if it is dead
-    std::vector<Asteroid::Ptr> asteroidsNew;
+    // Bury asteroid object if it is dead
+    FrameVector<Asteroid::Ptr> asteroidsNew;
+    asteroidsNew.reserve(asteroids.size());
     for (unsigned int i = 0; i < asteroids.size(); i++) {
         asteroids[i]->update();
         if (!asteroids[i]->isAlive()) {
             // Split asteroid to smaller pieces
             if (asteroids[i]->isDueSplit())
                 splitAsteroid_(asteroids[i].get());
-            // Create explosion
-            particleHandler_->createParticleExplosion(
-                asteroids[i]->getPosX(), asteroids[i]->getPosY(),
-                DEFAULT_EXPLOSION_SPEED, asteroids[i]->getVelX(),
-                asteroids[i]->getVelY(), asteroids[i]->size * 10,
-                DEFAULT_PARTICLE_LIFESPAN);
-
+            // Queue explosion, chain reactions are spread over frames
+            ParticleHandler *particles = particleHandler_;
+            auto x = static_cast<int>(asteroids[i]->getPosX());
+            auto y = static_cast<int>(asteroids[i]->getPosY());
+            double vx = asteroids[i]->getVelX();
+            double vy = asteroids[i]->getVelY();
+            double size = asteroids[i]->size;
+            g_spawn_queue.push(
+                1, static_cast<size_t>(size * 10),
+                [=](size_t, double delay_ms) {
+                    particles->emit(EFFECT_ASTEROID_EXPLOSION, x, y, 0.0, vx,
+                                    vy, size, delay_ms);
+                });
+
+            asteroids[i]->retire();
+            g_graveyard.bury(std::move(asteroids[i]));
         } else {
-            asteroidsNew.push_back(asteroids[i]);
+            asteroidsNew.push_back(std::move(asteroids[i]));
         }
     }
-    // Update asteroids
-    asteroids.clear();
-    asteroids = asteroidsNew;
+    // Update asteroids, reusing the capacity of the persistent vector
+    asteroids.assign(std::make_move_iterator(asteroidsNew.begin()),
+                     std::make_move_iterator(asteroidsNew.end()));
 }
 
 void AsteroidHandler::spawnAsteroid() {
@@ -285,6 +300,8 @@ void AsteroidHandler::setSpawnSpeed(unsigned int speed) { spawnspeed_ = speed; }
 
 /// Renderer is called each game tick
 void AsteroidHandler::update() {
+    ALLOC_SCOPE(ALLOC_ASTEROIDS);
+
 #if !DEBUG_ONE_ASTEROID && !DEBUG_TWO_ASTEROID_COLLISION && !DEBUG_NO_ASTEROIDS
 
     if (spawnTimer_.isDue()) {
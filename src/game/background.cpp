@@ -1,37 +1,122 @@
 #include "background.h"
 #include "rng.h"
 #include "../game.h"
+#include "../memory/alloctracker.h"
+#include <algorithm>
 
-Background::~Background() {
-    delete stars_s_;
-    delete stars_m_;
-    delete stars_l_;
+static const SDL_Color STAR_COLORS[STAR_L + 1] = {
+    SDL_Color{130, 100, 100, 180},
+    SDL_Color{150, 150, 150, 200},
+    SDL_Color{200, 200, 200, 240},
+};
+
+Background::Background(RenderEngine *renderEngine)
+    : RenderObject(renderEngine, BOTTOM_RENDER_LAYER_IDX) {
+    columns_ = (GAME_AREA_WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+    rows_ = (GAME_AREA_HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+    tiles_.resize(static_cast<size_t>(columns_ * rows_));
+    for (auto &t : tiles_)
+        t.texture.reset(new TextureSlot);
+
+    addStars_(STAR_S, createBackground_(STAR_S, stars_s_density,
+                                        GAME_AREA_WIDTH, GAME_AREA_HEIGHT));
+    addStars_(STAR_M, createBackground_(STAR_M, stars_m_density,
+                                        GAME_AREA_WIDTH, GAME_AREA_HEIGHT));
+    addStars_(STAR_L, createBackground_(STAR_L, stars_l_density,
+                                        GAME_AREA_WIDTH, GAME_AREA_HEIGHT));
 }
 
-Background::Background(RenderEngine *renderEngine) {
-    stars_s_ =
-        new Polygon(renderEngine,
-                        createBackground_(STAR_S, stars_s_density,
-                                          GAME_AREA_WIDTH, GAME_AREA_HEIGHT),
-                        0, 0);
-    stars_m_ =
-        new Polygon(renderEngine,
-                        createBackground_(STAR_M, stars_m_density,
-                                          GAME_AREA_WIDTH, GAME_AREA_HEIGHT),
-                        0, 0);
-    stars_l_ =
-        new Polygon(renderEngine,
-                        createBackground_(STAR_L, stars_l_density,
-                                          GAME_AREA_WIDTH, GAME_AREA_HEIGHT),
-                        0, 0);
-
-    stars_s_->setColor(SDL_Color{130, 100, 100, 180});
-    stars_m_->setColor(SDL_Color{150, 150, 150, 200});
-    stars_l_->setColor(SDL_Color{200, 200, 200, 240});
-
-    stars_s_->setRenderType(POINT);
-    stars_m_->setRenderType(POINT);
-    stars_l_->setRenderType(POINT);
+void Background::addStars_(star_types type,
+                           const std::vector<SDL_Point> &points) {
+    for (auto &p : points) {
+        if (p.x < 0 || p.y < 0 || p.x >= columns_ * TILE_SIZE ||
+            p.y >= rows_ * TILE_SIZE)
+            continue;
+
+        int column = p.x / TILE_SIZE;
+        int row = p.y / TILE_SIZE;
+        tiles_[row * columns_ + column].stars[type].push_back(SDL_Point{
+            p.x - column * TILE_SIZE, p.y - row * TILE_SIZE});
+    }
+}
+
+void Background::render(int offset_x, int offset_y) {
+    frame_++;
+
+    // Tiles overlapping the screen, offsets are negative world positions
+    int first_column = std::max(0, -offset_x / TILE_SIZE);
+    int first_row = std::max(0, -offset_y / TILE_SIZE);
+    int last_column =
+        std::min(columns_ - 1, (-offset_x + SCREEN_RES_W - 1) / TILE_SIZE);
+    int last_row =
+        std::min(rows_ - 1, (-offset_y + SCREEN_RES_H - 1) / TILE_SIZE);
+
+    RenderCommandBuffer &commands = renderEngine_->getCommandBuffer();
+    for (int row = first_row; row <= last_row; row++) {
+        for (int column = first_column; column <= last_column; column++) {
+            Tile &tile = tiles_[row * columns_ + column];
+            if (!tile.cached)
+                createTexture_(tile);
+
+            tile.last_used = frame_;
+            commands.copy(layer_, tile.texture,
+                          SDL_Rect{column * TILE_SIZE, row * TILE_SIZE,
+                                   TILE_SIZE, TILE_SIZE});
+        }
+    }
+}
+
+void Background::createTexture_(Tile &tile) {
+    ALLOC_SCOPE(ALLOC_RENDERING);
+    RenderCommandBuffer &commands = renderEngine_->getCommandBuffer();
+
+    if (cached_tiles_ >= MAX_CACHED_TILES) {
+        Tile *oldest = nullptr;
+        for (auto &t : tiles_) {
+            if (t.cached && (!oldest || t.last_used < oldest->last_used))
+                oldest = &t;
+        }
+        TextureSlot::Ptr slot = oldest->texture;
+        commands.defer([slot](SDL_Renderer *) {
+            if (slot->texture)
+                SDL_DestroyTexture(slot->texture);
+            slot->texture = nullptr;
+        });
+        oldest->cached = false;
+        cached_tiles_--;
+    }
+
+    tile.cached = true;
+    cached_tiles_++;
+
+    // Tasks run before the draw commands of the frame, the render target
+    // can be switched here. Stars are written opaque as with the blend mode
+    // used for the screen, the empty parts of the tile stay transparent.
+    // Star points never change after construction, so the task can read
+    // them from another thread.
+    TextureSlot::Ptr slot = tile.texture;
+    const std::vector<SDL_Point> *stars = tile.stars;
+    commands.defer([slot, stars](SDL_Renderer *renderer) {
+        slot->texture =
+            SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                              SDL_TEXTUREACCESS_TARGET, TILE_SIZE, TILE_SIZE);
+        if (!slot->texture) {
+            LOG("Background tile creation failed: %s", SDL_GetError());
+            return;
+        }
+
+        SDL_SetTextureBlendMode(slot->texture, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderTarget(renderer, slot->texture);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderClear(renderer);
+        for (int type = STAR_S; type <= STAR_L; type++) {
+            const SDL_Color &c = STAR_COLORS[type];
+            SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, 0xff);
+            SDL_RenderDrawPoints(renderer, stars[type].data(),
+                                 static_cast<int>(stars[type].size()));
+        }
+        SDL_SetRenderTarget(renderer, nullptr);
+    });
 }
 
 std::vector<SDL_Point>
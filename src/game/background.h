@@ -7,7 +7,6 @@
 
 #include "../rendering/renderengine.h"
 #include "../rendering/renderobject.h"
-#include "graphics.h"
 
 const static double stars_s_density = 0.001;
 const static double stars_m_density = 0.0001;
@@ -19,16 +18,51 @@ enum star_types { STAR_S, STAR_M, STAR_L };
 /// \brief The Background class represents a static background of stars and
 /// planets
 ///
-class Background {
+/// The game area is split into square tiles. The stars of a tile are drawn
+/// into a texture the first time the tile becomes visible, after that the
+/// tile is drawn with a single texture copy. Only tiles overlapping the
+/// viewport are drawn and at most MAX_CACHED_TILES textures are kept, the
+/// least recently drawn tile is released first. Tile textures are created
+/// and released by deferred render tasks.
+///
+class Background : public RenderObject {
   public:
-    ~Background();
+    /// Tile width and height in pixels
+    static const int TILE_SIZE = 512;
+
+    /// Number of tile textures kept in memory
+    static const size_t MAX_CACHED_TILES = 32;
+
     Background(RenderEngine *renderEngine);
 
+    ///
+    /// \brief Draws the visible tiles
+    /// \param offset_x viewport offset x
+    /// \param offset_y viewport offset y
+    ///
+    void render(int offset_x, int offset_y) override;
+
   private:
-    // Graphics elements
-    Polygon *stars_s_;
-    Polygon *stars_m_;
-    Polygon *stars_l_;
+    struct Tile {
+        std::vector<SDL_Point> stars[STAR_L + 1]; // tile-local star points
+        TextureSlot::Ptr texture;
+        bool cached = false;        // texture requested and not released
+        unsigned int last_used = 0; // frame the tile was last drawn on
+    };
+
+    ///
+    /// \brief Sorts the points of a star field into tiles
+    /// \param type star type
+    /// \param points star points in world coordinates
+    ///
+    void addStars_(star_types type, const std::vector<SDL_Point> &points);
+
+    ///
+    /// \brief Requests a texture with the stars of a tile, releasing the
+    /// least recently used tile if the cache is full
+    /// \param tile tile to draw
+    ///
+    void createTexture_(Tile &tile);
 
     // Functions
 
@@ -53,6 +87,12 @@ class Background {
     /// \return vector with SDL_Point points belonging to the star
     ///
     std::vector<SDL_Point> getStarShape_(star_types type, int x, int y);
+
+    std::vector<Tile> tiles_;
+    int columns_;
+    int rows_;
+    size_t cached_tiles_ = 0;
+    unsigned int frame_ = 0;
 };
 
 #endif // BACKGROUND_H
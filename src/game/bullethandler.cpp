@@ -1,22 +1,63 @@
 #include "bullethandler.h"
 #include "../game.h"
+#include <utility>
 
-BulletHandler::BulletHandler() {}
+BulletHandler::BulletHandler(PhysicsEngine *physicsEngine,
+                             RenderEngine *renderEngine, size_t pool_size)
+    : physicsEngine_(physicsEngine), renderEngine_(renderEngine) {
+    reserve_(pool_size);
+}
+
+BulletHandler::~BulletHandler() { slots_.clear(); }
+
+void BulletHandler::reserve_(size_t n) {
+    if (n <= slots_.size())
+        return;
 
-BulletHandler::~BulletHandler() { bullets_.clear(); }
+    // Grow in chunks to keep pool growth rare
+    size_t target = slots_.size() + POOL_GROWTH;
+    if (target < n)
+        target = n;
+
+    slots_.reserve(target);
+    while (slots_.size() < target)
+        slots_.emplace_back(new Bullet(renderEngine_, physicsEngine_));
+}
 
 void BulletHandler::update() {
-    // Delete dead particles
-    auto end = bullets_.end();
-    for (auto it = bullets_.begin(); it != end;) {
-        it->get()->update();
-        if (!it->get()->alive)
-            it = bullets_.erase(it);
-        else
-            ++it;
+    // Retire dead bullets by swapping them behind the active range. The
+    // swapped in bullet is updated on the next iteration.
+    size_t i = 0;
+    while (i < active_) {
+        Bullet *b = slots_[i].get();
+        b->update();
+        if (!b->alive) {
+            b->retire();
+            std::swap(slots_[i], slots_[--active_]);
+        } else {
+            ++i;
+        }
     }
 }
 
-void BulletHandler::addBullet(Bullet::Ptr bullet) { bullets_.insert(bullet); }
+Bullet *BulletHandler::addBullet(double direction_rad, double speed, double x,
+                                 double y, double vx, double vy,
+                                 Entity *owner) {
+    Bullet *b = addBullets(1)[0];
+    b->launch(direction_rad, speed, x, y, vx, vy, owner);
+    return b;
+}
+
+BulletSpan BulletHandler::addBullets(size_t n) {
+    reserve_(active_ + n);
+    BulletSpan span(slots_.data() + active_, n);
+    active_ += n;
+    return span;
+}
+
+BulletSpan BulletHandler::getBullets() const {
+    return BulletSpan(slots_.data(), active_);
+}
 
-std::set<Bullet::Ptr> BulletHandler::getBullets() { return bullets_; }
+size_t BulletHandler::size() const { return active_; }
+size_t BulletHandler::capacity() const { return slots_.size(); }
@@ -2,33 +2,116 @@
 #define BULLETHANDLER_H
 
 #include "weapons/bullet.h"
-#include <set>
+#include <memory>
+#include <vector>
 
+///
+/// \brief Non-owning view over a range of bullet slots
+///
+class BulletSpan {
+  public:
+    typedef const std::unique_ptr<Bullet> *Slot;
+
+    class iterator {
+      public:
+        explicit iterator(Slot slot) : slot_(slot) {}
+        Bullet *operator*() const { return slot_->get(); }
+        iterator &operator++() {
+            ++slot_;
+            return *this;
+        }
+        bool operator==(const iterator &o) const { return slot_ == o.slot_; }
+        bool operator!=(const iterator &o) const { return slot_ != o.slot_; }
+
+      private:
+        Slot slot_;
+    };
+
+    BulletSpan(Slot first, size_t n) : first_(first), n_(n) {}
+
+    [[nodiscard]] iterator begin() const { return iterator(first_); }
+    [[nodiscard]] iterator end() const { return iterator(first_ + n_); }
+    [[nodiscard]] size_t size() const { return n_; }
+    [[nodiscard]] bool empty() const { return n_ == 0; }
+    Bullet *operator[](size_t i) const { return first_[i].get(); }
+
+  private:
+    Slot first_;
+    size_t n_;
+};
+
+///
+/// \brief Pooled, contiguous bullet storage
+///
+/// Bullets live in a slot array where the first size() slots are active.
+/// Expired bullets are retired and swapped with the last active slot, so
+/// removal is O(1) and the bullet object stays in the pool for reuse. Pool
+/// bullets stay registered with the engines, which means firing and expiring
+/// bullets does not allocate once the pool has grown to its working size.
+/// Retired bullets are parked, so they are left out of the entity snapshots
+/// and skipped by the physics step.
+///
 class BulletHandler {
   public:
-    BulletHandler();
+    static const size_t DEFAULT_POOL_SIZE = 256;
+    static const size_t POOL_GROWTH = 64;
+
+    BulletHandler(PhysicsEngine *physicsEngine, RenderEngine *renderEngine,
+                  size_t pool_size = DEFAULT_POOL_SIZE);
     ~BulletHandler();
 
     ///
-    /// \brief Run update tasks on bullets and delete bullets out-of-bounds
+    /// \brief Run update tasks on bullets and retire bullets out-of-bounds
     ///
     void update();
 
     ///
-    /// \brief Add a bullet to the handler
-    /// \param bullet Bullet instance
+    /// \brief Launches a single bullet from the pool
+    /// \param direction_rad launch direction
+    /// \param speed launch speed
+    /// \param x launch coordinate x
+    /// \param y launch coordinate y
+    /// \param vx launcher speed in x direction
+    /// \param vy launcher speed in y direction
+    /// \param owner entity firing the bullet
+    /// \return launched bullet
     ///
-    void addBullet(Bullet::Ptr bullet);
+    Bullet *addBullet(double direction_rad, double speed, double x, double y,
+                      double vx, double vy, Entity *owner);
+
+    ///
+    /// \brief Reserves a batch of bullets for a volley. The returned bullets
+    /// are active but not yet launched, the caller must call launch() on
+    /// each of them during the same frame.
+    /// \param n number of bullets
+    /// \return view over the reserved bullets
+    ///
+    BulletSpan addBullets(size_t n);
 
     ///
     /// \brief Get currently active bullets
-    /// \return set of bullets
+    /// \return view over the active bullets, valid until the next update
     ///
-    std::set<Bullet::Ptr> getBullets();
+    [[nodiscard]] BulletSpan getBullets() const;
+
+    /// Number of active bullets
+    [[nodiscard]] size_t size() const;
+
+    /// Number of pooled bullet objects
+    [[nodiscard]] size_t capacity() const;
 
   private:
-    // Data structure for storing the shot bullets
-    std::set<Bullet::Ptr> bullets_;
+    ///
+    /// \brief Grows the pool to hold at least n bullets
+    ///
+    void reserve_(size_t n);
+
+    PhysicsEngine *physicsEngine_;
+    RenderEngine *renderEngine_;
+
+    // Slot array, slots [0, active_) hold the active bullets
+    std::vector<std::unique_ptr<Bullet>> slots_;
+    size_t active_ = 0;
 };
 
 #endif // BULLETHANDLER_H
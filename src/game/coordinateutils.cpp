@@ -116,3 +116,89 @@ void CoordinateUtils::translate(SDL_Point *dest, SDL_Point *src,
         dest[i].y = src[i].y + offset_y;
     }
 }
+
+namespace {
+
+inline long long cross(const SDL_Point &a, const SDL_Point &b,
+                       const SDL_Point &c) {
+    return static_cast<long long>(b.x - a.x) * (c.y - a.y) -
+           static_cast<long long>(b.y - a.y) * (c.x - a.x);
+}
+
+} // namespace
+
+void CoordinateUtils::triangulate(const SDL_Point *outline, int size,
+                                  std::vector<int> &indices) {
+    indices.clear();
+    if (size > 1 && outline[0].x == outline[size - 1].x &&
+        outline[0].y == outline[size - 1].y)
+        size--;
+    if (size < 3)
+        return;
+
+    std::vector<int> remaining(static_cast<size_t>(size));
+    long long area = 0;
+    for (int i = 0; i < size; i++) {
+        remaining[i] = i;
+        const SDL_Point &a = outline[i];
+        const SDL_Point &b = outline[(i + 1) % size];
+        area += static_cast<long long>(a.x) * b.y -
+                static_cast<long long>(b.x) * a.y;
+    }
+    int orientation = area >= 0 ? 1 : -1;
+
+    size_t i = 0;
+    size_t stalled = 0;
+    while (remaining.size() > 3) {
+        size_t n = remaining.size();
+        i %= n;
+        int prev = remaining[(i + n - 1) % n];
+        int cur = remaining[i];
+        int next = remaining[(i + 1) % n];
+        long long turn =
+            cross(outline[prev], outline[cur], outline[next]) * orientation;
+
+        // Collinear vertices are dropped without a triangle
+        bool ear = turn >= 0;
+        for (size_t k = 0; ear && turn > 0 && k < n; k++) {
+            int v = remaining[k];
+            if (v == prev || v == cur || v == next)
+                continue;
+            // Points on the triangle edges block the ear as well, unless
+            // they coincide with its corners
+            const SDL_Point &p = outline[v];
+            if ((p.x == outline[prev].x && p.y == outline[prev].y) ||
+                (p.x == outline[cur].x && p.y == outline[cur].y) ||
+                (p.x == outline[next].x && p.y == outline[next].y))
+                continue;
+            if (cross(outline[prev], outline[cur], p) * orientation >= 0 &&
+                cross(outline[cur], outline[next], p) * orientation >= 0 &&
+                cross(outline[next], outline[prev], p) * orientation >= 0)
+                ear = false;
+        }
+
+        if (ear) {
+            if (turn > 0) {
+                indices.push_back(prev);
+                indices.push_back(cur);
+                indices.push_back(next);
+            }
+            remaining.erase(remaining.begin() + static_cast<long>(i));
+            stalled = 0;
+        } else if (++stalled > n) {
+            // No ear found, the outline intersects itself. Fan the rest.
+            for (size_t k = 1; k + 1 < n; k++) {
+                indices.push_back(remaining[0]);
+                indices.push_back(remaining[k]);
+                indices.push_back(remaining[k + 1]);
+            }
+            return;
+        } else {
+            i++;
+        }
+    }
+
+    indices.push_back(remaining[0]);
+    indices.push_back(remaining[1]);
+    indices.push_back(remaining[2]);
+}
@@ -3,6 +3,7 @@
 
 #include "SDL2/SDL.h"
 #include <math.h>
+#include <vector>
 
 typedef struct point {
     double x;
@@ -117,6 +118,16 @@ namespace CoordinateUtils {
     ///
     extern void translate(SDL_Point *dest, SDL_Point *src,
                           int size, int offset_x, int offset_y);
+
+    ///
+    /// \brief Triangulates a simple polygon by ear clipping
+    /// \param outline polygon points, a closing point equal to the first one
+    /// is ignored
+    /// \param size number of points
+    /// \param indices output, three outline indices per triangle
+    ///
+    extern void triangulate(const SDL_Point *outline, int size,
+                            std::vector<int> &indices);
 };
 
 #endif // COORDINATEUTILS_H
@@ -2,9 +2,11 @@
 #include "rng.h"
 
 EntityList Entity::entities_;
+size_t Entity::pending_removals_ = 0;
 
 Entity::~Entity() {
-    entities_.remove(this);
+    if (listed_)
+        entities_.remove(this);
 }
 
 Entity::Entity(bool identifiable, EntityType type)
@@ -54,7 +56,38 @@ Polygon * Entity::getBody() {
 }
 
 void Entity::setCollidable(bool collidable) { collidable_ = collidable; }
-EntityList Entity::getEntities() { return entities_; }
+void Entity::setParked(bool parked) { parked_ = parked; }
+bool Entity::isParked() const { return parked_; }
+FrameEntityList Entity::getEntities() {
+    FrameEntityList entities;
+    entities.reserve(entities_.size() - pending_removals_);
+    for (auto e : entities_) {
+        if (!e->removal_pending_ && !e->parked_)
+            entities.push_back(e);
+    }
+    return entities;
+}
+
+void Entity::markForRemoval() {
+    if (!removal_pending_) {
+        removal_pending_ = true;
+        pending_removals_++;
+    }
+}
+
+void Entity::purgeEntities() {
+    if (pending_removals_ == 0)
+        return;
+
+    entities_.remove_if([](Entity *e) {
+        if (e->removal_pending_) {
+            e->listed_ = false;
+            return true;
+        }
+        return false;
+    });
+    pending_removals_ = 0;
+}
 bool Entity::hasId() { return identifiable_; }
 bool Entity::hasOwner() { return owned_; }
 bool Entity::isCollidable() const { return collidable_; }
@@ -1,6 +1,7 @@
 #ifndef ENTITY_H
 #define ENTITY_H
 #include "graphics.h"
+#include "../memory/framearena.h"
 #include <list>
 #include <bitset>
 
@@ -32,6 +33,7 @@ enum EntityType {
 ///
 class Entity;
 typedef std::list<Entity*> EntityList;
+typedef FrameVector<Entity*> FrameEntityList;
 class Entity
 {
     static const int ENTITY_MAX_ID = 25600000;
@@ -56,9 +58,20 @@ public:
     Entity(Entity* owner, bool identifiable, EntityType type = UNDEFINED);
 
 
-    /// Get vector of active entities
-    /// \return
-    static EntityList getEntities();
+    /// Get a snapshot of the active entities, parked entities are left out.
+    /// The snapshot is allocated from the frame arena and is only valid
+    /// during the current frame.
+    /// \return vector of active entities
+    static FrameEntityList getEntities();
+
+    /// Removes all entities marked for removal from the entity list in a
+    /// single pass
+    static void purgeEntities();
+
+    /// Marks the entity for batched removal from the entity list. The entity
+    /// is no longer returned by getEntities() and is unlisted on the next
+    /// purgeEntities() call.
+    void markForRemoval();
 
     /// Checks if the entity can collide with other entities of the given type
     /// \param t entity type to check against
@@ -101,6 +114,16 @@ public:
     /// \param collidable whether the entity is collidable
     void setCollidable(bool collidable);
 
+    /// Parks the entity. A parked entity stays in the entity list but is not
+    /// returned by getEntities(), so pooled objects can be taken out of play
+    /// and brought back without touching the list.
+    /// \param parked whether the entity is parked
+    void setParked(bool parked);
+
+    /// Checks if the entity is parked
+    /// \return true if the entity is parked
+    [[nodiscard]] bool isParked() const;
+
     /// Get score
     /// \return score
     [[nodiscard]] int getScore() const;
@@ -134,6 +157,7 @@ public:
 
 protected:
     static EntityList entities_;
+    static size_t pending_removals_;
     EntityType type_ = UNDEFINED;
     Entity* owner_ = nullptr;
     std::bitset<_entity_type_max> collidesWith_;
@@ -147,6 +171,9 @@ protected:
     bool identifiable_;
     bool owned_;
     bool collidable_;
+    bool removal_pending_ = false;
+    bool listed_ = true;
+    bool parked_ = false;
 
 };
 #endif // ENTITY_H
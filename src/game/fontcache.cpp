@@ -0,0 +1,103 @@
+#include "fontcache.h"
+#include "../blaster.h"
+#include "../memory/alloctracker.h"
+#include "../resources/FreeSans.h"
+#include "SDL2/SDL_ttf.h"
+#include <algorithm>
+
+FontCache g_font_cache;
+
+namespace {
+
+// Glyphs per atlas row
+const int ATLAS_COLUMNS = 16;
+
+} // namespace
+
+int GlyphAtlas::glyphIndex(char c) {
+    if (c < FIRST_GLYPH || c > LAST_GLYPH)
+        c = '?';
+    return c - FIRST_GLYPH;
+}
+
+const GlyphAtlas *FontCache::get(int size, RenderCommandBuffer &buffer) {
+    auto it = atlases_.find(size);
+    if (it != atlases_.end())
+        return it->second.get();
+
+    ALLOC_SCOPE(ALLOC_TEXT);
+    std::unique_ptr<GlyphAtlas> atlas = build_(size, buffer);
+    const GlyphAtlas *result = atlas.get();
+    // Failed sizes are cached as well so that they are not retried
+    atlases_.emplace(size, std::move(atlas));
+    return result;
+}
+
+std::unique_ptr<GlyphAtlas> FontCache::build_(int size,
+                                              RenderCommandBuffer &buffer) {
+    SDL_RWops *io = SDL_RWFromMem(FreeSans::getBytes(), FreeSans::getSize());
+    TTF_Font *font = TTF_OpenFontRW(io, 1, size);
+    if (font == nullptr) {
+        LOG("Font loading failed: %s", TTF_GetError());
+        return nullptr;
+    }
+
+    // Glyphs are rendered in white, the text colour is applied when drawing
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface *glyphs[GlyphAtlas::GLYPH_COUNT];
+    int cell_w = 1;
+    int cell_h = TTF_FontHeight(font);
+    for (int i = 0; i < GlyphAtlas::GLYPH_COUNT; i++) {
+        glyphs[i] = TTF_RenderGlyph_Solid(
+            font, static_cast<Uint16>(GlyphAtlas::FIRST_GLYPH + i), white);
+        if (glyphs[i]) {
+            cell_w = std::max(cell_w, glyphs[i]->w);
+            cell_h = std::max(cell_h, glyphs[i]->h);
+        }
+    }
+
+    int rows = (GlyphAtlas::GLYPH_COUNT + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(
+        0, cell_w * ATLAS_COLUMNS, cell_h * rows, 32, SDL_PIXELFORMAT_RGBA32);
+
+    std::unique_ptr<GlyphAtlas> atlas(new GlyphAtlas);
+    atlas->texture.reset(new TextureSlot);
+    atlas->line_height = TTF_FontLineSkip(font);
+    for (int i = 0; i < GlyphAtlas::GLYPH_COUNT; i++) {
+        SDL_Rect &rect = atlas->glyphs[i];
+        rect.x = (i % ATLAS_COLUMNS) * cell_w;
+        rect.y = (i / ATLAS_COLUMNS) * cell_h;
+        rect.w = glyphs[i] ? glyphs[i]->w : 0;
+        rect.h = glyphs[i] ? glyphs[i]->h : 0;
+
+        int advance = rect.w;
+        TTF_GlyphMetrics(font, static_cast<Uint16>(GlyphAtlas::FIRST_GLYPH + i),
+                         nullptr, nullptr, nullptr, nullptr, &advance);
+        atlas->advances[i] = advance;
+
+        if (glyphs[i] && surface) {
+            SDL_Rect dst = rect;
+            SDL_BlitSurface(glyphs[i], nullptr, surface, &dst);
+        }
+        SDL_FreeSurface(glyphs[i]);
+    }
+    TTF_CloseFont(font);
+
+    if (surface == nullptr) {
+        LOG("Creating glyph atlas failed: %s", SDL_GetError());
+        return atlas;
+    }
+
+    // The atlas texture is kept until the renderer is destroyed
+    TextureSlot::Ptr slot = atlas->texture;
+    buffer.defer([slot, surface](SDL_Renderer *renderer) {
+        slot->texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (slot->texture)
+            SDL_SetTextureBlendMode(slot->texture, SDL_BLENDMODE_BLEND);
+        SDL_FreeSurface(surface);
+    });
+
+    LOG("Built %dx%d glyph atlas for font size %d", surface->w, surface->h,
+        size);
+    return atlas;
+}
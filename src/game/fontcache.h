@@ -0,0 +1,66 @@
+#ifndef FONTCACHE_H
+#define FONTCACHE_H
+
+#include "../rendering/rendercommandbuffer.h"
+#include "SDL2/SDL.h"
+#include <map>
+#include <memory>
+
+///
+/// \brief Pre-rendered printable ASCII glyphs of one font size
+///
+/// All glyphs live in a single white texture, text is drawn as one textured
+/// quad per character modulated with the text colour.
+///
+struct GlyphAtlas {
+    static const char FIRST_GLYPH = ' ';
+    static const char LAST_GLYPH = '~';
+    static const int GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1;
+
+    /// Glyph texture, created by the thread owning the renderer
+    TextureSlot::Ptr texture;
+    /// Glyph rectangles in the texture, indexed by character - FIRST_GLYPH
+    SDL_Rect glyphs[GLYPH_COUNT];
+    /// Horizontal pen advance per glyph
+    int advances[GLYPH_COUNT];
+    /// Distance between two lines of text
+    int line_height;
+
+    ///
+    /// \brief Maps a character to its glyph index, unknown characters are
+    /// drawn as '?'
+    ///
+    static int glyphIndex(char c);
+};
+
+///
+/// \brief Glyph atlases of the embedded font, keyed by point size
+///
+/// An atlas is rasterized once, the first time its size is asked for, and
+/// kept for the lifetime of the program. Text updates only look up glyph
+/// rectangles, they neither rasterize nor allocate textures.
+///
+class FontCache {
+  public:
+    ///
+    /// \brief Gets the atlas of a font size, building it on first use
+    /// \param size point size
+    /// \param buffer command buffer the texture upload is deferred to
+    /// \return atlas, nullptr if the font could not be loaded
+    ///
+    const GlyphAtlas *get(int size, RenderCommandBuffer &buffer);
+
+  private:
+    ///
+    /// \brief Rasterizes all glyphs of a size into an atlas
+    ///
+    static std::unique_ptr<GlyphAtlas> build_(int size,
+                                              RenderCommandBuffer &buffer);
+
+    std::map<int, std::unique_ptr<GlyphAtlas>> atlases_;
+};
+
+/// Font cache of the game thread
+extern FontCache g_font_cache;
+
+#endif // FONTCACHE_H
@@ -1,12 +1,14 @@
 #include "graphics.h"
 #include "../game.h"
+#include "../memory/framearena.h"
+#include "../rendering/polygonlod.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <utility>
 
 Polygon::~Polygon() {
-    delete[] outline;
-    delete[] render_buffer;
-    delete[] fill_render_buffer;
+    delete[] outline_;
 }
 
 Polygon::Polygon(): RenderObject()  {}
@@ -14,7 +16,7 @@ Polygon::Polygon(): RenderObject()  {}
 Polygon::Polygon(RenderEngine *renderEngine,
                  std::vector<SDL_Point> outline, int x, int y) :
     RenderObject() {
-    init(renderEngine, std::move(outline), x, y);
+    init(renderEngine, outline, x, y);
 }
 
 Polygon::Polygon(RenderEngine *renderEngine, SDL_Point *outline,
@@ -24,24 +26,21 @@ Polygon::Polygon(RenderEngine *renderEngine, SDL_Point *outline,
     y_ = y;
     this->x = x;
     this->y = y;
-    this->outline = outline;
+    this->outline_ = outline;
     this->points = points;
 
-    double x_temp, y_temp, r_temp;
+    double r_temp;
     for (unsigned long i = 0; i < static_cast<unsigned long>(points); i++) {
-        x_temp = outline[i].x;
-        y_temp = outline[i].y;
-        this->coordinates.push_back(Point{x_temp, y_temp});
+        local_.push_back(Point{static_cast<double>(outline[i].x - x),
+                               static_cast<double>(outline[i].y - y)});
         r_temp = CoordinateUtils::distance(outline[i], SDL_Point{x, y});
         if (r_temp > max_r_)
             max_r_ = r_temp;
     }
-
-    render_buffer = new SDL_Point[points];
 }
 
 void Polygon::init(RenderEngine *renderEngine,
-                   std::vector<SDL_Point> initial_outline,
+                   const SDL_Point *initial_outline, int n,
                    int x, int y) {
     RenderObject::init(renderEngine);
     renderEngine_ = renderEngine;
@@ -50,31 +49,38 @@ void Polygon::init(RenderEngine *renderEngine,
     y_ = y;
     this->x = x;
     this->y = y;
-    points = static_cast<int>(initial_outline.size());
-    this->outline = new SDL_Point[initial_outline.size()];
+    points = n;
+    this->outline_ = new SDL_Point[n];
+    local_.reserve(n);
 
-    double x_temp, y_temp, r_temp;
+    double r_temp;
     for (unsigned long i = 0; i < static_cast<unsigned long>(points); i++) {
-        this->outline[i] = initial_outline[i];
-        x_temp = initial_outline[i].x;
-        y_temp = initial_outline[i].y;
-        this->coordinates.push_back(Point{x_temp, y_temp});
+        this->outline_[i] = initial_outline[i];
+        local_.push_back(
+            Point{static_cast<double>(initial_outline[i].x - x),
+                  static_cast<double>(initial_outline[i].y - y)});
         r_temp = CoordinateUtils::distance(initial_outline[i], SDL_Point{x, y});
         if (r_temp > max_r_)
             max_r_ = r_temp;
     }
-
-    render_buffer = new SDL_Point[points];
+    buildLod_();
 }
 
-void Polygon::updateOutline_() {
-    int x_temp, y_temp;
+void Polygon::updateOutline_() const {
+    if (!outline_dirty_)
+        return;
     for (unsigned long i = 0; i < static_cast<unsigned long>(points); i++) {
-        Point coord = coordinates[i];
-        x_temp = static_cast<int>(coord.x);
-        y_temp = static_cast<int>(coord.y);
-        outline[i] = SDL_Point{x_temp, y_temp};
+        const Point &p = local_[i];
+        outline_[i] = SDL_Point{
+            static_cast<int>(x_ + (p.x * cos_ - p.y * sin_)),
+            static_cast<int>(y_ + (p.x * sin_ + p.y * cos_))};
     }
+    outline_dirty_ = false;
+}
+
+SDL_Point *Polygon::getOutline() {
+    updateOutline_();
+    return outline_;
 }
 
 void Polygon::updateCenterPoint_() {
@@ -82,35 +88,11 @@ void Polygon::updateCenterPoint_() {
     y = static_cast<int>(y_);
 }
 
-void Polygon::updateExtremes_() {
-    max_x_ = static_cast<int>(max_x_d_);
-    min_x_ = static_cast<int>(min_x_d_);
-    max_y_ = static_cast<int>(max_y_d_);
-    min_y_ = static_cast<int>(min_y_d_);
-
-}
-
 void Polygon::move(double amount_x, double amount_y) {
-    int x_old = x;
-    int y_old = y;
     x_ += amount_x;
     y_ += amount_y;
-
-    max_x_d_ += amount_x;
-    min_x_d_ += amount_x;
-    max_y_d_ += amount_y;
-    min_y_d_ += amount_y;
-
-    for (unsigned long i = 0; i < static_cast<unsigned long>(points); i++) {
-        coordinates[i].x += amount_x;
-        coordinates[i].y += amount_y;
-    }
-
     updateCenterPoint_();
-    updateOutline_();
-    updateExtremes_();
-    if (renderType_ == FILL)
-        moveFill_(x - x_old, y - y_old);
+    outline_dirty_ = true;
 }
 
 void Polygon::moveAbsolute(double dest_x, double dest_y) {
@@ -122,13 +104,15 @@ bool Polygon::intersects(Polygon *p) {
         return false;
 
     SDL_Point *a,*b,*c,*d;
+    SDL_Point *outline = getOutline();
+    SDL_Point *other = p->getOutline();
 
     for (int i = 0; i < points - 1; i++) {
         a = &outline[i];
         b = &outline[i + 1];
         for (int j = 0; j < p->points - 1; j++) {
-            c = &p->outline[j];
-            d = &p->outline[j + 1];
+            c = &other[j];
+            d = &other[j + 1];
             if (CoordinateUtils::line_intersection(a, b, c, d))
                 return true;
         }
@@ -143,24 +127,26 @@ bool Polygon::intersects(Polygon *p) {
 }
 
 void Polygon::rotate(double angle_rad, int origin_x, int origin_y) {
-    for (unsigned long i = 0; i < static_cast<unsigned long>(points); i++) {
-        coordinates[i] = CoordinateUtils::rotate_point(
-                    origin_x, origin_y, angle_rad, coordinates[i]);
-    }
+    Point center = CoordinateUtils::rotate_point(origin_x, origin_y,
+                                                 angle_rad, Point{x_, y_});
+    x_ = center.x;
+    y_ = center.y;
+    updateCenterPoint_();
 
-    updateOutline_();
+    angle_ += angle_rad;
+    cos_ = cos(angle_);
+    sin_ = sin(angle_);
+    outline_dirty_ = true;
     maxValUpdated_ = false;
+    fill_dirty_ = true;
 }
 
 bool Polygon::outOfBounds(int buffer) {
-    for (int i = 0; i < points; i++) {
-        SDL_Point p = outline[i];
-        if (!CoordinateUtils::check_out_of_bounds(p.x, p.y, buffer)) {
-            return false;
-        }
-    }
-
-    return true;
+    // Tested with the cached bounding box, so the outline is not built. A
+    // polygon only counts as out of bounds when all of it is beyond the
+    // same edge of the game area.
+    return getMaxX() + buffer < 0 || getMinX() - buffer > GAME_AREA_WIDTH ||
+           getMaxY() + buffer < 0 || getMinY() - buffer > GAME_AREA_HEIGHT;
 }
 
 bool Polygon::isCloseToQ(Polygon *p) {
@@ -191,76 +177,147 @@ bool Polygon::isCloseTo(SDL_Point *p) {
 }
 
 void Polygon::searchExtremes_() {
-    max_x_d_ = getExtremePoint_(X, MAX);
-    min_x_d_ = getExtremePoint_(X, MIN);
-    max_y_d_ = getExtremePoint_(Y, MAX);
-    min_y_d_ = getExtremePoint_(Y, MIN);
-    updateExtremes_();
-    maxValUpdated_ = true;
-}
-
-int Polygon::getExtremePoint_(Dimension d, Extremity e) const {
-    int extremity;
-
+    // The outline is truncated to integers, which keeps the order of the
+    // points, so the extremes of the outline are the truncated extremes of
+    // the rotated coordinates at any position
+    max_x_d_ = min_x_d_ = max_y_d_ = min_y_d_ = 0.0;
     for (int i = 0; i < points; i++) {
-        int candidate;
-        SDL_Point *p = &outline[i];
-
-        if (d == X) {
-            candidate = p->x;
-        } else if (d == Y) {
-            candidate = p->y;
-        }
-
-        if (i == 0)
-            extremity = candidate;
-        else {
-            if (e == MAX) {
-                if (candidate > extremity)
-                    extremity = candidate;
-            } else if (e == MIN) {
-                if (candidate < extremity)
-                    extremity = candidate;
-            }
-        }
+        const Point &p = local_[i];
+        double rx = p.x * cos_ - p.y * sin_;
+        double ry = p.x * sin_ + p.y * cos_;
+        if (i == 0 || rx > max_x_d_)
+            max_x_d_ = rx;
+        if (i == 0 || rx < min_x_d_)
+            min_x_d_ = rx;
+        if (i == 0 || ry > max_y_d_)
+            max_y_d_ = ry;
+        if (i == 0 || ry < min_y_d_)
+            min_y_d_ = ry;
     }
-
-    return extremity;
+    maxValUpdated_ = true;
 }
 
 void Polygon::setColor(SDL_Color color) { color_ = color; }
 
 void Polygon::setRenderType(RenderType renderType) {
     renderType_ = renderType;
+    SDL_Point *outline = getOutline();
     if (renderType_ == FILL) {
 
         if (!checkClosedOutline_(outline))
             throw std::invalid_argument("Outline is not enclosed");
 
-        fill = new SDL_Point[GAME_AREA_HEIGHT * 2];
-        fill_render_buffer = new SDL_Point[GAME_AREA_HEIGHT * 2];
-        calculateFill_();
+        fill_dirty_ = true;
+#if HAS_RENDER_GEOMETRY
+        CoordinateUtils::triangulate(outline, points, fill_indices_);
+#endif
+    }
+    buildLod_();
+}
+
+void Polygon::buildLod_() {
+    lod_outline_.clear();
+    lod_fill_indices_.clear();
+    SDL_Point *outline = getOutline();
+
+    // Every other point of the open outline, at least a hexagon is kept
+    int corners = checkClosedOutline_(outline) ? points - 1 : points;
+    if (renderType_ == POINT || corners < 6)
+        return;
+    for (int i = 0; i < corners; i += 2)
+        lod_outline_.push_back(i);
+    lod_outline_.push_back(0);
+
+#if HAS_RENDER_GEOMETRY
+    if (renderType_ == FILL) {
+        FrameVector<SDL_Point> simplified;
+        for (int i : lod_outline_)
+            simplified.push_back(outline[i]);
+        CoordinateUtils::triangulate(simplified.data(),
+                                     static_cast<int>(simplified.size()),
+                                     lod_fill_indices_);
+    }
+#endif
+}
+
+size_t Polygon::renderSimplified_(RenderCommandBuffer &commands, bool fill) {
+    SDL_Point *outline = getOutline();
+    FrameVector<SDL_Point> simplified;
+    simplified.reserve(lod_outline_.size());
+    for (int i : lod_outline_)
+        simplified.push_back(outline[i]);
+    auto n = static_cast<int>(simplified.size());
+    commands.drawLines(layer_, color_, simplified.data(), n);
+    if (!fill)
+        return simplified.size();
+
+#if HAS_RENDER_GEOMETRY
+    if (commands.hasGeometry()) {
+        commands.drawTriangles(layer_, color_, simplified.data(), n,
+                               lod_fill_indices_.data(),
+                               static_cast<int>(lod_fill_indices_.size()));
+        return simplified.size() * 2;
     }
+#endif
+    // Spans are cached, the full fill costs no more than a simplified one
+    if (fill_dirty_)
+        rasterizeFill_();
+    commands.fillRects(layer_, color_, fill_spans_.data(),
+                       static_cast<int>(fill_spans_.size()),
+                       x - fill_origin_x_, y - fill_origin_y_);
+    return simplified.size() + static_cast<size_t>(points);
 }
 
-void Polygon::render(int offset_x, int offset_y) {
-    CoordinateUtils::translate(render_buffer, outline,
-                             points, offset_x, offset_y);
-    SDL_SetRenderDrawColor(Game::RENDERER,
-                           color_.r,
-                           color_.g,
-                           color_.b,
-                           color_.a);
+void Polygon::render(int, int) {
+    RenderCommandBuffer &commands = renderEngine_->getCommandBuffer();
+
+    if (renderType_ != POINT) {
+        // Outline plus, for fills, the fill vertices
+        size_t full = renderType_ == FILL ? points * 2 : points;
+        switch (g_polygon_lod.select(max_r_)) {
+        case LOD_POINT: {
+            SDL_Point center{x, y};
+            commands.drawPoints(layer_, color_, &center, 1);
+            g_polygon_lod.count(full, 1);
+            return;
+        }
+        case LOD_OUTLINE:
+            if (lod_outline_.empty())
+                break;
+            g_polygon_lod.count(full, renderSimplified_(commands, false));
+            return;
+        case LOD_SIMPLIFIED:
+            if (lod_outline_.empty())
+                break;
+            g_polygon_lod.count(
+                full, renderSimplified_(commands, renderType_ == FILL));
+            return;
+        case LOD_FULL:
+            break;
+        }
+        g_polygon_lod.count(full, full);
+    }
 
+    SDL_Point *outline = getOutline();
     if (renderType_ == LINE || renderType_ == FILL)
-        SDL_RenderDrawLines(Game::RENDERER, render_buffer, points);
+        commands.drawLines(layer_, color_, outline, points);
     else if (renderType_ == POINT)
-        SDL_RenderDrawPoints(Game::RENDERER, render_buffer, points);
+        commands.drawPoints(layer_, color_, outline, points);
 
     if (renderType_ == FILL) {
-        CoordinateUtils::translate(fill_render_buffer, fill,
-                                   n_fill_points, offset_x, offset_y);
-        SDL_RenderDrawLines(Game::RENDERER, fill_render_buffer, n_fill_points);
+#if HAS_RENDER_GEOMETRY
+        if (commands.hasGeometry()) {
+            commands.drawTriangles(layer_, color_, outline, points,
+                                   fill_indices_.data(),
+                                   static_cast<int>(fill_indices_.size()));
+            return;
+        }
+#endif
+        if (fill_dirty_)
+            rasterizeFill_();
+        commands.fillRects(layer_, color_, fill_spans_.data(),
+                           static_cast<int>(fill_spans_.size()),
+                           x - fill_origin_x_, y - fill_origin_y_);
     }
 }
 
@@ -269,85 +326,113 @@ SDL_Color Polygon::getColor() { return color_; }
 int Polygon::getMaxX() {
     if (!maxValUpdated_)
         searchExtremes_();
-    return max_x_;
+    return static_cast<int>(x_ + max_x_d_);
 }
 int Polygon::getMinX() {
     if (!maxValUpdated_)
         searchExtremes_();
-    return min_x_;
+    return static_cast<int>(x_ + min_x_d_);
 }
 int Polygon::getMaxY() {
     if (!maxValUpdated_)
         searchExtremes_();
-    return max_y_;
+    return static_cast<int>(y_ + max_y_d_);
 }
 int Polygon::getMinY() {
     if (!maxValUpdated_)
         searchExtremes_();
-    return min_y_;
+    return static_cast<int>(y_ + min_y_d_);
 }
 
 double Polygon::getMaxRadius() const {
     return max_r_;
 }
 
-void Polygon::calculateFill_() {
-    if (!outline)
+void Polygon::rasterizeFill_() {
+    fill_spans_.clear();
+    fill_origin_x_ = x;
+    fill_origin_y_ = y;
+    fill_dirty_ = false;
+    if (!outline_ || points < 2)
+        return;
+    SDL_Point *outline = getOutline();
+
+    // Edge table, edges are active on scanlines [y_min, y_max)
+    struct Edge {
+        int y_min;
+        int y_max;
+        double x;     // intersection with the current scanline
+        double slope; // x change per scanline
+    };
+    FrameVector<Edge> edges;
+    edges.reserve(points);
+    for (int i = 0; i < points - 1; i++) {
+        SDL_Point a = outline[i];
+        SDL_Point b = outline[i + 1];
+        if (a.y == b.y)
+            continue;
+        if (a.y > b.y)
+            std::swap(a, b);
+        edges.push_back(Edge{a.y, b.y, static_cast<double>(a.x),
+                             static_cast<double>(b.x - a.x) / (b.y - a.y)});
+    }
+    if (edges.empty())
         return;
 
-    // Get the min and max y points to determine the horizontal scanline limits
-    int min_y = getMinY();
-    int max_y = getMaxY();
-
-    n_fill_points = 0;
-    for (int y_idx = min_y; y_idx < max_y; y_idx++) {
-        SDL_Point a1 = {static_cast<int>(-GAME_AREA_WIDTH * 0.5), y_idx};
-        SDL_Point a2 = {static_cast<int>(GAME_AREA_WIDTH * 1.5), y_idx};
-        SDL_Point intersection;
-
-        // Find scanline start and end points
-        for (int i = 0; i < points - 1; i++) {
-            int n_intersects = 0;
-            if (CoordinateUtils::line_intersection(
-                        &a1, &a2, &outline[i], &outline[i + 1])) {
-                if (CoordinateUtils::line_intersection_point(
-                        &a1, &a2, &outline[i], &outline[i + 1],
-                        &intersection)) {
-                    fill[n_fill_points] = intersection;
-                    if (++n_fill_points > GAME_AREA_HEIGHT * 2)
-                        break;
-                    if (++n_intersects == 2)
-                        break;
-                }
-            }
+    std::sort(edges.begin(), edges.end(),
+              [](const Edge &a, const Edge &b) { return a.y_min < b.y_min; });
+
+    int max_y = 0;
+    for (auto &e : edges)
+        max_y = std::max(max_y, e.y_max);
+
+    FrameVector<Edge> active;
+    active.reserve(edges.size());
+    size_t next = 0;
+    for (int row = edges[0].y_min; row < max_y; row++) {
+        while (next < edges.size() && edges[next].y_min == row)
+            active.push_back(edges[next++]);
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [row](const Edge &e) {
+                                        return e.y_max <= row;
+                                    }),
+                     active.end());
+
+        // Few edges are active at once, insertion sort by x
+        for (size_t i = 1; i < active.size(); i++) {
+            for (size_t k = i; k > 0 && active[k].x < active[k - 1].x; k--)
+                std::swap(active[k], active[k - 1]);
         }
 
-        // Safety measures to avoid segmentation faults
-        if (n_fill_points > GAME_AREA_HEIGHT * 2) {
-            n_fill_points = GAME_AREA_HEIGHT * 2;
-            break;
+        // Even-odd rule, the space between every pair of edges is inside
+        for (size_t i = 0; i + 1 < active.size(); i += 2) {
+            auto x0 = static_cast<int>(std::lround(active[i].x));
+            auto x1 = static_cast<int>(std::lround(active[i + 1].x));
+            fill_spans_.push_back(SDL_Rect{x0 - fill_origin_x_,
+                                           row - fill_origin_y_,
+                                           x1 - x0 + 1, 1});
         }
-    }
-}
 
-void Polygon::moveFill_(int x_amount, int y_amount) {
-    for (int i = 0; i < n_fill_points; ++i) {
-        fill[i].x += x_amount;
-        fill[i].y += y_amount;
+        for (auto &e : active)
+            e.x += e.slope;
     }
 }
 
 void Polygon::rotate(double angle_rad) {
-    Polygon::rotate(angle_rad, x, y);
-    if (renderType_ == FILL)
-        calculateFill_();
+    angle_ += angle_rad;
+    cos_ = cos(angle_);
+    sin_ = sin(angle_);
+    outline_dirty_ = true;
+    maxValUpdated_ = false;
+    fill_dirty_ = true;
 }
 
 bool Polygon::contains(SDL_Point *p) const {
     // Efficient winding algorithm
     // http://geomalgorithms.com/a03-_inclusion.html
     int wn = 0;
-    SDL_Point *V = outline;
+    updateOutline_();
+    SDL_Point *V = outline_;
     for (int i = 0; i < points - 1; i++) {
         if (V[i].y <= p->y) {
             if (V[i + 1].y > p->y)
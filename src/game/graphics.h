@@ -28,16 +28,15 @@ enum RenderType { FILL, LINE, POINT };
 ///
 /// SDL coordinates and positions are handled as integers and are such unusable
 /// for movement and rotational calculations due to possible cumulative rounding
-/// errors. To overcome this, all graphic instances store their coordinates as
-/// double values and all calculations are done using these numbers.
+/// errors. To overcome this, the outline is stored once as double valued
+/// coordinates relative to the center point, together with the position and
+/// rotation of the polygon.
 ///
-/// After each calculation updateOutline_() is called to update the SDL
-/// -compatible integer coordinates from the newly refreshed double values.
-///
-/// Important variables:
-///
-/// SDL_Point* outline      Holds the integer based coordinates for rendering
-/// Coordinate coordinates  Hold the double valued coordinates for calculations
+/// Moving or rotating the polygon only updates its position and rotation. The
+/// SDL-compatible integer outline is derived from them by updateOutline_()
+/// when it is read, so polygons that are neither drawn nor tested for
+/// collisions cost O(1) per move. The bounding box is kept relative to the
+/// center point and is only searched again after a rotation.
 ///
 class Polygon : public RenderObject {
 
@@ -46,24 +45,11 @@ class Polygon : public RenderObject {
 
   private:
     ///
-    /// \brief Finds the position of an objects extreme point
-    /// in the given direction.
-    /// \param d dimension to search in
-    /// \param e extremity to find
-    /// \return extreme point position
-    ///
-    int getExtremePoint_(Dimension d, Extremity e) const;
-
-    ///
-    /// \brief Searches extreme point locations
+    /// \brief Searches the extreme points of the rotated outline, relative
+    /// to the center point
     ///
     void searchExtremes_();
 
-    ///
-    /// \brief Updates extreme point locations
-    ///
-    void updateExtremes_();
-
     ///
     /// \brief Updates the objects center point based
     ///  on internal floating point values.
@@ -71,25 +57,30 @@ class Polygon : public RenderObject {
     void updateCenterPoint_();
 
     ///
-    /// \brief Updates the objects outline coordinates
-    /// based on internal floating point values.
+    /// \brief Updates the outline from the local coordinates, position and
+    /// rotation if the polygon moved or rotated since the last update
     ///
-    void updateOutline_();
+    void updateOutline_() const;
 
     // Variables
-    double max_r_;
+    double max_r_ = 0.0;
     double x_, y_;
-    int max_x_, min_x_, max_y_, min_y_;
-    double max_x_d_, min_x_d_, max_y_d_, min_y_d_;
+    double angle_ = 0.0;
+    double cos_ = 1.0;
+    double sin_ = 0.0;
+    double max_x_d_, min_x_d_, max_y_d_, min_y_d_; // relative to (x_, y_)
     bool maxValUpdated_ = false;
     RenderType renderType_ = LINE;
     SDL_Color color_ = SDL_Color{0xff, 0xff, 0xff, 0xff};
-    SDL_Point *render_buffer = nullptr;
+
+    // Outline relative to the center point, without rotation
+    std::vector<Point> local_;
+    // Integer outline in world coordinates, see updateOutline_()
+    SDL_Point *outline_ = nullptr;
+    mutable bool outline_dirty_ = false;
 
   public:
     int x, y;
-    SDL_Point *outline = nullptr;
-    std::vector<Point> coordinates;
     int points;
 
     ///
@@ -125,20 +116,42 @@ class Polygon : public RenderObject {
     Polygon(RenderEngine *renderEngine, std::vector<SDL_Point> outline,
                 int x, int y);
 
-    void init(RenderEngine *renderEngine, std::vector<SDL_Point> initial_outline,
-              int x, int y);
+    ///
+    /// \brief Initializes the primitive from an outline array. The points are
+    /// copied, so the source may be a frame-local temporary.
+    /// \param renderEngine RenderEngine instance
+    /// \param initial_outline outline points
+    /// \param n number of outline points
+    /// \param x initial center x coordinate
+    /// \param y initial center y coordinate
+    ///
+    void init(RenderEngine *renderEngine, const SDL_Point *initial_outline,
+              int n, int x, int y);
+
+    template <typename Alloc>
+    void init(RenderEngine *renderEngine,
+              const std::vector<SDL_Point, Alloc> &initial_outline, int x,
+              int y) {
+        init(renderEngine, initial_outline.data(),
+             static_cast<int>(initial_outline.size()), x, y);
+    }
 
     ///
-    /// \brief Moves each point of the primitive by given amount of
-    /// pixels
+    /// \brief Gets the outline in world coordinates, updated on demand
+    /// \return outline array with points entries, valid until the polygon
+    /// is destroyed
+    ///
+    SDL_Point *getOutline();
+
+    ///
+    /// \brief Moves the primitive by given amount of pixels
     /// \param amount_x x movement
     /// \param amount_y y movement
     ///
     void move(double amount_x, double amount_y);
 
     ///
-    /// \brief Moves each point of the primitive to absolute
-    /// location (by center point)
+    /// \brief Moves the primitive to absolute location (by center point)
     /// \param dest_x x destination
     /// \param dest_y y destination
     ///
@@ -146,7 +159,7 @@ class Polygon : public RenderObject {
 
     ///
     /// \brief Rotates the primitive by given angle around given
-    /// point
+    /// point, the center point moves along
     /// \param angle_rad amount of rotation in radians
     /// \param x rotation origin x
     /// \param y rotation origin y
@@ -162,8 +175,8 @@ class Polygon : public RenderObject {
 
     ///
     /// \brief Checks if the primitive is completely out of bounds (OOB).
-    /// \param buffer optional buffer in pixels. Individual points have to
-    /// be OOB at least by this amount.
+    /// \param buffer optional buffer in pixels. The bounding box has to be
+    /// OOB at least by this amount.
     /// \return true if the primitive is OOB
     ///
     bool outOfBounds(int buffer = 0);
@@ -228,10 +241,14 @@ class Polygon : public RenderObject {
     void setRenderType(RenderType renderType);
 
     ///
-    /// \brief Renders the graphics primitive with the given camera
-    /// offset.
-    /// \param offset_x x offset
-    /// \param offset_y y offset
+    /// \brief Records the graphics primitive to the frame command buffer
+    /// with the given camera offset. Fills are drawn as triangles when the
+    /// renderer supports geometry, otherwise as spans that are rasterized
+    /// here if the polygon was rotated since they were last drawn. Line and
+    /// fill polygons are simplified by on-screen size, see PolygonLod. The
+    /// outline is recorded in world coordinates as is.
+    /// \param offset_x camera offset x, unused
+    /// \param offset_y camera offset y, unused
     ///
     void render(int offset_x, int offset_y) override;
 
@@ -258,13 +275,40 @@ class Polygon : public RenderObject {
         }
     }
 
-    void calculateFill_();
-    void moveFill_(int x_amount, int y_amount);
-    SDL_Point* fill_render_buffer = nullptr;
+    ///
+    /// \brief Rasterizes the outline into horizontal fill spans with an
+    /// active edge table. Spans are stored relative to the center point so
+    /// that moving the polygon does not invalidate them.
+    ///
+    void rasterizeFill_();
+
+    /// Fill spans, one pixel high, relative to (fill_origin_x_,
+    /// fill_origin_y_)
+    std::vector<SDL_Rect> fill_spans_;
+    int fill_origin_x_ = 0;
+    int fill_origin_y_ = 0;
+    bool fill_dirty_ = true;
+
+    /// Fill triangles as outline indices. Rotation and translation do not
+    /// change the triangulation, so it is computed once.
+    std::vector<int> fill_indices_;
+
+    ///
+    /// \brief Builds the simplified outline and its triangulation
+    ///
+    void buildLod_();
+
+    ///
+    /// \brief Records the simplified outline, and its fill if requested
+    /// \return number of vertices recorded
+    ///
+    size_t renderSimplified_(RenderCommandBuffer &commands, bool fill);
 
-    /// Class variables
-    SDL_Point *fill = nullptr;
-    int n_fill_points = 0;
+    /// Simplified outline as closed list of outline indices, empty if the
+    /// outline is too small to simplify
+    std::vector<int> lod_outline_;
+    /// Fill triangles of the simplified outline, as lod_outline_ indices
+    std::vector<int> lod_fill_indices_;
 
 };
 
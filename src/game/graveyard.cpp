@@ -0,0 +1,41 @@
+#include "graveyard.h"
+#include "../blaster.h"
+#include "entity.h"
+#include "SDL2/SDL.h"
+
+Graveyard g_graveyard;
+
+void Graveyard::flush() {
+    Uint64 start = SDL_GetPerformanceCounter();
+    size_t batch = dead_.size();
+
+    if (batch > 0) {
+        // Prune the entity list once for the whole batch, then release the
+        // objects. clear() keeps the capacity for the next frame.
+        Entity::purgeEntities();
+        dead_.clear();
+    }
+
+    last_batch_ = batch;
+    total_deferred_ += batch;
+    if (batch > max_batch_)
+        max_batch_ = batch;
+
+    last_flush_us_ = static_cast<double>(SDL_GetPerformanceCounter() - start) *
+                     1000000.0 /
+                     static_cast<double>(SDL_GetPerformanceFrequency());
+
+#if DEBUG_GRAVEYARD
+    if (++frames_ % GRAVEYARD_REPORT_INTERVAL == 0)
+        LOG("Graveyard: %llu objects deferred in total, last batch %zu "
+            "(%.1f us), max batch %zu",
+            static_cast<unsigned long long>(total_deferred_), last_batch_,
+            last_flush_us_, max_batch_);
+#endif
+}
+
+size_t Graveyard::getPending() const { return dead_.size(); }
+size_t Graveyard::getLastBatch() const { return last_batch_; }
+size_t Graveyard::getMaxBatch() const { return max_batch_; }
+uint64_t Graveyard::getTotalDeferred() const { return total_deferred_; }
+double Graveyard::getLastFlushTime() const { return last_flush_us_; }
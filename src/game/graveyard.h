@@ -0,0 +1,71 @@
+#ifndef GRAVEYARD_H
+#define GRAVEYARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+///
+/// \brief Deferred, batched destruction of dead game objects
+///
+/// Objects that die during a tick are buried instead of destroyed on the
+/// spot. Buried objects keep their engine registrations until the end of the
+/// frame, when flush() tears all of them down in one pass: the entity list is
+/// pruned once for the whole batch, after which the objects are released and
+/// their physics and render registrations removed.
+///
+/// The caller is responsible for making a buried object inert (no rendering,
+/// no collisions) before burying it. Teardown has to happen on the game
+/// thread since the engine registries are not synchronized.
+///
+class Graveyard {
+  public:
+    Graveyard() = default;
+
+    Graveyard(const Graveyard &) = delete;
+    Graveyard &operator=(const Graveyard &) = delete;
+
+    ///
+    /// \brief Queues an object for destruction at the end of the frame
+    /// \param obj object to bury
+    ///
+    template <typename T> void bury(std::shared_ptr<T> obj) {
+        dead_.push_back(std::move(obj));
+    }
+
+    ///
+    /// \brief Destroys all buried objects
+    ///
+    void flush();
+
+    /// Objects currently waiting for destruction
+    [[nodiscard]] size_t getPending() const;
+
+    /// Objects destroyed by the last flush
+    [[nodiscard]] size_t getLastBatch() const;
+
+    /// Largest number of objects destroyed by a single flush
+    [[nodiscard]] size_t getMaxBatch() const;
+
+    /// Total number of objects destroyed through the graveyard
+    [[nodiscard]] uint64_t getTotalDeferred() const;
+
+    /// Duration of the last flush in microseconds
+    [[nodiscard]] double getLastFlushTime() const;
+
+  private:
+    // Type-erased owners, the original deleter is kept by shared_ptr
+    std::vector<std::shared_ptr<void>> dead_;
+
+    size_t last_batch_ = 0;
+    size_t max_batch_ = 0;
+    uint64_t total_deferred_ = 0;
+    double last_flush_us_ = 0.0;
+    uint64_t frames_ = 0;
+};
+
+/// Graveyard shared by the game thread
+extern Graveyard g_graveyard;
+
+#endif // GRAVEYARD_H
@@ -0,0 +1,149 @@
+#include "minimap.h"
+#include "../memory/alloctracker.h"
+#include <algorithm>
+
+// Distance of the minimap from the bottom right screen corner
+static const int MINIMAP_MARGIN = 10;
+
+// Within a layer rectangles are drawn before points and points before
+// textures, whatever their colour. The frame is recorded as points so that
+// it is always drawn over the backdrop.
+static const SDL_Color BACKDROP_COLOR = SDL_Color{0x08, 0x08, 0x28, 0xff};
+static const SDL_Color FRAME_COLOR = SDL_Color{0x80, 0x80, 0xa0, 0xff};
+
+// Cell pixels, ARGB8888. Empty cells are transparent.
+static const uint32_t SHIP_PIXEL = 0xff40ff40;
+static const uint32_t OTHER_PIXEL = 0xffff4040;
+
+Minimap::Minimap(RenderEngine *renderEngine)
+    : RenderObject(renderEngine, HUD_RENDER_LAYER_IDX) {
+    columns_ = (GAME_AREA_WIDTH + CELL_SIZE - 1) / CELL_SIZE;
+    rows_ = (GAME_AREA_HEIGHT + CELL_SIZE - 1) / CELL_SIZE;
+    cells_.resize(static_cast<size_t>(columns_ * rows_), Cell{0, 0, 0});
+    pixels_.resize(cells_.size(), 0);
+    texture_.reset(new TextureSlot);
+
+    int w = columns_ * SCALE;
+    int h = rows_ * SCALE;
+    dst_ = SDL_Rect{SCREEN_RES_W - w - MINIMAP_MARGIN,
+                    SCREEN_RES_H - h - MINIMAP_MARGIN, w, h};
+}
+
+int Minimap::passOf_(const Entity *e) {
+    auto key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(e) >> 4);
+    return static_cast<int>((key * 0x9e3779b97f4a7c15ull >> 32) %
+                            UPDATE_FRAMES);
+}
+
+void Minimap::update(const FrameEntityList &entities) {
+    // Asteroids are spread over the pass by their address, which does not
+    // change while the list grows, shrinks or is reordered, so each one is
+    // counted once per pass. Other entities are few and are placed on the
+    // last frame of the pass, so markers show where they are when published.
+    bool last_frame = pass_ == UPDATE_FRAMES - 1;
+    for (Entity *e : entities) {
+        EntityType type = e->getType();
+        if (type == BULLET || (type == ASTEROID && passOf_(e) != pass_) ||
+            (type != ASTEROID && !last_frame))
+            continue;
+
+        Polygon *body = e->getBody();
+        if (!body || body->x < 0 || body->y < 0 ||
+            body->x >= GAME_AREA_WIDTH || body->y >= GAME_AREA_HEIGHT)
+            continue;
+
+        Cell &cell = cells_[(body->y / CELL_SIZE) * columns_ +
+                            body->x / CELL_SIZE];
+        switch (type) {
+        case ASTEROID:
+            if (cell.asteroids < UINT16_MAX)
+                cell.asteroids++;
+            break;
+        case SHIP:
+            cell.ships = 1;
+            break;
+        default:
+            cell.others = 1;
+            break;
+        }
+    }
+
+    if (++pass_ < UPDATE_FRAMES)
+        return;
+    publish_();
+    pass_ = 0;
+    std::fill(cells_.begin(), cells_.end(), Cell{0, 0, 0});
+}
+
+void Minimap::publish_() {
+    ALLOC_SCOPE(ALLOC_RENDERING);
+
+    for (size_t i = 0; i < cells_.size(); i++) {
+        const Cell &cell = cells_[i];
+        if (cell.ships) {
+            pixels_[i] = SHIP_PIXEL;
+        } else if (cell.others) {
+            pixels_[i] = OTHER_PIXEL;
+        } else if (cell.asteroids) {
+            // Denser cells are brighter
+            auto grey = static_cast<uint32_t>(
+                std::min(255, 96 + 48 * (cell.asteroids - 1)));
+            pixels_[i] = 0xff000000 | grey << 16 | grey << 8 | grey;
+        } else {
+            pixels_[i] = 0;
+        }
+    }
+
+    RenderCommandBuffer &commands = renderEngine_->getCommandBuffer();
+    TextureSlot::Ptr slot = texture_;
+    int columns = columns_;
+    int rows = rows_;
+    if (!texture_requested_) {
+        texture_requested_ = true;
+        commands.defer([slot, columns, rows](SDL_Renderer *renderer) {
+            slot->texture = SDL_CreateTexture(renderer,
+                                              SDL_PIXELFORMAT_ARGB8888,
+                                              SDL_TEXTUREACCESS_STREAMING,
+                                              columns, rows);
+            if (!slot->texture) {
+                LOG("Minimap texture creation failed: %s", SDL_GetError());
+                return;
+            }
+            SDL_SetTextureBlendMode(slot->texture, SDL_BLENDMODE_BLEND);
+        });
+    }
+
+    // The task may run on the render thread after the next pass started,
+    // it uploads its own copy of the pixels
+    commands.defer([slot, columns, pixels = pixels_](SDL_Renderer *) {
+        if (slot->texture)
+            SDL_UpdateTexture(slot->texture, nullptr, pixels.data(),
+                              columns * static_cast<int>(sizeof(uint32_t)));
+    });
+}
+
+void Minimap::render(int offset_x, int offset_y) {
+    RenderCommandBuffer &commands = renderEngine_->getCommandBuffer();
+    commands.fillRects(layer_, BACKDROP_COLOR, &dst_, 1);
+
+    // Visible area, offsets are negative world positions
+    int x0 = dst_.x + -offset_x * SCALE / CELL_SIZE;
+    int y0 = dst_.y + -offset_y * SCALE / CELL_SIZE;
+    int x1 = dst_.x + (-offset_x + SCREEN_RES_W) * SCALE / CELL_SIZE;
+    int y1 = dst_.y + (-offset_y + SCREEN_RES_H) * SCALE / CELL_SIZE;
+    x1 = std::min(x1, dst_.x + dst_.w - 1);
+    y1 = std::min(y1, dst_.y + dst_.h - 1);
+    frame_.clear();
+    for (int x = x0; x <= x1; x++) {
+        frame_.push_back(SDL_Point{x, y0});
+        frame_.push_back(SDL_Point{x, y1});
+    }
+    for (int y = y0 + 1; y < y1; y++) {
+        frame_.push_back(SDL_Point{x0, y});
+        frame_.push_back(SDL_Point{x1, y});
+    }
+    commands.drawPoints(layer_, FRAME_COLOR, frame_.data(),
+                        static_cast<int>(frame_.size()));
+
+    commands.copy(layer_, texture_, dst_);
+}
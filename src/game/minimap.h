@@ -0,0 +1,88 @@
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+#include "../rendering/renderengine.h"
+#include "../rendering/renderobject.h"
+#include "entity.h"
+#include "SDL2/SDL.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+///
+/// \brief The Minimap class shows the whole game area in a corner of the
+/// screen
+///
+/// The game area is divided into cells of CELL_SIZE. Asteroids are counted
+/// into the cells incrementally, every update() takes the share of them
+/// assigned to the current frame so a full pass is spread over
+/// UPDATE_FRAMES frames. Ships and other entities are placed on the last
+/// frame of a pass. After a pass the grid is turned into one pixel per cell
+/// and uploaded to a small streaming texture by a deferred render task.
+///
+/// Drawing costs one texture copy, a backdrop and the frame of the visible
+/// area, independent of the number of entities.
+///
+class Minimap : public RenderObject {
+  public:
+    typedef std::shared_ptr<Minimap> Ptr;
+
+    /// Cell width and height in game coordinates
+    static const int CELL_SIZE = 64;
+
+    /// Screen pixels per cell
+    static const int SCALE = 2;
+
+    /// Frames a full pass over the entities is spread over
+    static const int UPDATE_FRAMES = 10;
+
+    ///
+    /// \brief Creates the minimap, the texture is created with the first
+    /// completed pass
+    /// \param renderEngine RenderEngine instance
+    ///
+    explicit Minimap(RenderEngine *renderEngine);
+
+    ///
+    /// \brief Counts this frame's share of the entities into the grid
+    /// \param entities active entities of this frame
+    ///
+    void update(const FrameEntityList &entities);
+
+    ///
+    /// \brief Draws the minimap and the frame of the visible area
+    /// \param offset_x camera offset x
+    /// \param offset_y camera offset y
+    ///
+    void render(int offset_x, int offset_y) override;
+
+  private:
+    struct Cell {
+        uint16_t asteroids;
+        uint8_t ships;
+        uint8_t others;
+    };
+
+    ///
+    /// \brief Converts the counted grid to pixels and uploads them
+    ///
+    void publish_();
+
+    ///
+    /// \brief Gets the frame of the pass an asteroid is counted on
+    ///
+    static int passOf_(const Entity *e);
+
+    int columns_;
+    int rows_;
+    std::vector<Cell> cells_;
+    std::vector<uint32_t> pixels_;
+    int pass_ = 0;
+
+    TextureSlot::Ptr texture_;
+    bool texture_requested_ = false;
+    SDL_Rect dst_;
+    std::vector<SDL_Point> frame_; // points of the visible area frame
+};
+
+#endif // MINIMAP_H
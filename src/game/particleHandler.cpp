@@ -1,90 +1,239 @@
 #include "particleHandler.h"
 
-#include <memory>
+#include <algorithm>
+#include <cmath>
+#include "coordinateutils.h"
 #include "rng.h"
+#include "../memory/alloctracker.h"
+#include "../memory/framearena.h"
 #include "../game.h"
 
-ParticleHandler::ParticleHandler(PhysicsEngine *physicsEngine,
-                                 RenderEngine *renderEngine)
-    : physicsEngine_(physicsEngine), renderEngine_(renderEngine) {}
+// Mass of a particle with a radius of 0.5, used for random momentum
+static const double PARTICLE_MASS = DENSITY * PI * 0.25;
+
+// Particles with less time to live are removed
+static const float PARTICLE_MIN_TTL = 2.0f;
+
+// Emitters this close to the screen edge count as visible
+static const int ON_SCREEN_MARGIN = 100;
+
+ParticleHandler::ParticleHandler(RenderEngine *renderEngine,
+                                 const std::string &effects_path)
+    : RenderObject(renderEngine, WORLD_TOP_RENDER_LAYER_IDX - 2),
+      pool_(PARTICLE_WORKERS), seed_(gen()), last_update_(SDL_GetTicks()) {
+    effects_.load(effects_path);
+}
 
 void ParticleHandler::update() {
-    // Delete dead particles
-    std::vector<Particle::Ptr> particles_new;
-    particles_new.reserve(particles.size());
-    for (auto & p : particles) {
-        p->update();
-        if (p->alive)
-            particles_new.push_back(p);
+    ALLOC_SCOPE(ALLOC_PARTICLES);
+
+    Uint32 now = SDL_GetTicks();
+    auto delta = static_cast<float>(now - last_update_);
+    last_update_ = now;
+
+    auto decay = static_cast<float>(1.0 - FRICTION_DECAY * g_timescale);
+
+    // Simulate in parallel chunks, every chunk gets its own random stream
+    size_t n = x_.size();
+    size_t n_chunks = (n + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    uint64_t frame_seed = seed_ + (frame_++ << 20);
+    pool_.parallelFor(n_chunks, [&](size_t chunk) {
+        size_t first = chunk * CHUNK_SIZE;
+        size_t last = std::min(n, first + CHUNK_SIZE);
+        FastRng rng(frame_seed + chunk);
+        updateRange_(first, last, delta, decay, rng);
+    });
+
+    // Compact the particles that died during the parallel pass
+    size_t alive = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (ttl_[i] >= PARTICLE_MIN_TTL) {
+            if (alive != i)
+                move_(alive, i);
+            alive++;
+        }
     }
 
-    particles.clear();
-    particles = particles_new;
+    resize_(alive);
 }
 
-void ParticleHandler::createParticle(double direction_rad, double launch_speed,
-                                     double vx, double vy, int x, int y,
-                                     int max_lifespan, SDL_Color color,
-                                     ParticleSize size) {
+void ParticleHandler::updateRange_(size_t first, size_t last, float delta,
+                                   float decay, FastRng &rng) {
+    for (size_t i = first; i < last; i++) {
+        // This part calculates some arbitary movement during lifespan of a
+        // particle
+        int volatility = effects_.get(effect_[i]).volatility;
+        if (volatility > 0 && rng.nextInt(100) + 1 < volatility) {
+            double direction = rng.nextInt(10) / 10.0 * 2 * PI;
+            double magnitude = rng.nextInt(10) / 10.0 * 0.0015;
+            double a = magnitude / PARTICLE_MASS * delta;
+            vx_[i] += static_cast<float>(std::cos(direction) * a);
+            vy_[i] += static_cast<float>(std::sin(direction) * a);
+            // Reducing lifespan of deviating particles to prevent lucky,
+            // super fast, particles
+            ttl_[i] -= 1.0f;
+        }
 
-    // Calculate initial direction and speed based on launch speed and launching
-    // party movement
-    double px = launch_speed * cos(direction_rad);
-    double py = launch_speed * sin(direction_rad);
+        x_[i] += vx_[i] * delta;
+        y_[i] += vy_[i] * delta;
+        vx_[i] *= decay;
+        vy_[i] *= decay;
 
-    px += vx;
-    py += vy;
+        // Count down particle lifespan
+        ttl_[i] -= delta;
 
-    double speed = sqrt(pow(px, 2) + pow(py, 2));
-    double theta = atan2(py, px);
+        // Out of bounds particles die, they are removed after the pass
+        if (CoordinateUtils::check_out_of_bounds(static_cast<int>(x_[i]),
+                                                 static_cast<int>(y_[i]), 1))
+            ttl_[i] = 0.0f;
+    }
+}
 
-    int ttl = random_int_in_range<int>(1, max_lifespan);
+void ParticleHandler::render(int, int) {
+    draw_calls_ = 0;
 
-    particles.push_back(std::make_shared<Particle>(physicsEngine_, renderEngine_, theta, speed, x, y, ttl, color, size));
+    size_t n = x_.size();
+    if (n == 0)
+        return;
 
-}
+    // Counting sort of the particle points into buckets of effect and
+    // lifetime step, every bucket has a single color from the effect table
+    const int steps = ParticleEffect::LUT_SIZE;
+    size_t n_buckets = effects_.size() * steps;
+    FrameVector<uint32_t> offsets(n_buckets + 1, 0);
+    FrameVector<uint32_t> bucket(n);
+    FrameVector<uint8_t> shape(n);
+    for (size_t i = 0; i < n; i++) {
+        float spent = 1.0f - ttl_[i] / max_ttl_[i];
+        int step = std::clamp(static_cast<int>(spent * steps), 0, steps - 1);
+        const ParticleEffect &e = effects_.get(effect_[i]);
+        bucket[i] = effect_[i] * steps + step;
+        shape[i] = std::min(size_[i], e.sizes[step]);
+        offsets[bucket[i] + 1] += shape[i] == PARTICLE_M ? 5 : 1;
+    }
+    for (size_t b = 0; b < n_buckets; b++)
+        offsets[b + 1] += offsets[b];
 
-void ParticleHandler::resetParticles() { particles.clear(); }
-
-void ParticleHandler::createParticleBurst(double heading, double speed, int x,
-                                          int y, double vx, double vy,
-                                          int amount, double spread,
-                                          int max_lifespan, SDL_Color color,
-                                          bool normal) {
-    double heading_lo = heading - (spread / 2);
-    double heading_hi = heading + (spread / 2);
-    double heading_r;
-    for (int j = 1; j <= amount; j++) {
-        if (normal)
-            heading_r = random_float_in_range(heading_lo, heading_hi,
-                                              Distribution::NORMAL);
-        else
-            heading_r = random_float_in_range(heading_lo, heading_hi,
-                                              Distribution::UNIFORM);
-
-        double speed_r = random_normal_float(speed, speed / 4);
-        if (random_int_in_range<int>(0, 2) > 1) {
-            createParticle(heading_r, speed_r, vx, vy, x, y, max_lifespan,
-                           color, ParticleSize::PARTICLE_M);
+    FrameVector<SDL_Point> points(offsets[n_buckets]);
+    FrameVector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < n; i++) {
+        int x = static_cast<int>(x_[i]);
+        int y = static_cast<int>(y_[i]);
+        SDL_Point *p = &points[cursor[bucket[i]]];
+        if (shape[i] == PARTICLE_M) {
+            p[0] = {x, y - 1};
+            p[1] = {x - 1, y};
+            p[2] = {x + 1, y};
+            p[3] = {x, y + 1};
+            p[4] = {x, y};
+            cursor[bucket[i]] += 5;
         } else {
-            createParticle(heading_r, speed_r, vx, vy, x, y, max_lifespan,
-                           color, ParticleSize::PARTICLE_S);
+            p[0] = {x, y};
+            cursor[bucket[i]] += 1;
         }
     }
+
+    for (size_t b = 0; b < n_buckets; b++) {
+        int count = static_cast<int>(offsets[b + 1] - offsets[b]);
+        if (count == 0)
+            continue;
+
+        const SDL_Color &c = effects_.get(b / steps).colors[b % steps];
+        renderEngine_->getCommandBuffer().drawPoints(
+            layer_, c, &points[offsets[b]], count);
+        draw_calls_++;
+    }
 }
 
-void ParticleHandler::createParticleExplosion(int x, int y, double speed,
-                                              double vx, double vy, int amount,
-                                              int max_lifespan,
-                                              SDL_Color color) {
-    for (int i = 0; i < amount; ++i) {
-        double angle = 2 * PI * (static_cast<double>(i) / amount);
-        double random_speed_factor = random_float_in_range(0.1, 1.9, NORMAL);
-        if (random_int_in_range<int>(0, 2) > 1)
-            createParticle(angle, speed * random_speed_factor, vx, vy, x, y,
-                           max_lifespan, color, ParticleSize::PARTICLE_M);
-        else
-            createParticle(angle, speed * random_speed_factor, vx, vy, x, y,
-                           max_lifespan, color, ParticleSize::PARTICLE_S);
+void ParticleHandler::emit(int effect, int x, int y, double heading,
+                           double vx, double vy, double amount_scale,
+                           double delay_ms) {
+    ALLOC_SCOPE(ALLOC_PARTICLES);
+    const ParticleEffect &e = effects_.get(effect);
+
+    auto amount = static_cast<size_t>(std::max(0.0, e.amount * amount_scale));
+    auto n = static_cast<int>(budget_.grant(amount, isOnScreen_(x, y)));
+
+    for (int i = 0; i < n; i++) {
+        double direction;
+        double speed;
+        if (e.shape == EFFECT_EXPLOSION) {
+            // Scaled down explosions keep their particles evenly spread
+            direction = 2 * PI * (static_cast<double>(i) / n);
+            speed = e.speed * random_float_in_range(0.1, 1.9, NORMAL);
+        } else {
+            direction = random_float_in_range(heading - e.spread / 2,
+                                              heading + e.spread / 2,
+                                              e.normal ? NORMAL : UNIFORM);
+            speed = random_normal_float(e.speed, e.speed / 4);
+        }
+
+        ParticleSize size = random_float_in_range(0.0, 1.0) < e.large_share
+                                ? PARTICLE_M
+                                : PARTICLE_S;
+        spawn_(effect, direction, speed, vx, vy, x, y, size, delay_ms);
     }
 }
+
+void ParticleHandler::spawn_(int effect, double direction_rad,
+                             double launch_speed, double vx, double vy, int x,
+                             int y, ParticleSize size, double delay_ms) {
+    // Calculate initial speed based on launch speed and launching party
+    // movement
+    double px = launch_speed * cos(direction_rad) + vx;
+    double py = launch_speed * sin(direction_rad) + vy;
+
+    int lifespan = effects_.get(effect).lifespan;
+    auto max_ttl = static_cast<float>(random_int_in_range<int>(1, lifespan));
+
+    // Deferred particles continue from where they would be by now
+    auto ttl = max_ttl - static_cast<float>(delay_ms);
+    if (ttl < PARTICLE_MIN_TTL)
+        return;
+
+    x_.push_back(static_cast<float>(x + px * delay_ms));
+    y_.push_back(static_cast<float>(y + py * delay_ms));
+    vx_.push_back(static_cast<float>(px));
+    vy_.push_back(static_cast<float>(py));
+    ttl_.push_back(ttl);
+    max_ttl_.push_back(max_ttl);
+    effect_.push_back(static_cast<uint16_t>(effect));
+    size_.push_back(static_cast<uint8_t>(size));
+}
+
+void ParticleHandler::move_(size_t dst, size_t src) {
+    x_[dst] = x_[src];
+    y_[dst] = y_[src];
+    vx_[dst] = vx_[src];
+    vy_[dst] = vy_[src];
+    ttl_[dst] = ttl_[src];
+    max_ttl_[dst] = max_ttl_[src];
+    effect_[dst] = effect_[src];
+    size_[dst] = size_[src];
+}
+
+void ParticleHandler::resize_(size_t n) {
+    x_.resize(n);
+    y_.resize(n);
+    vx_.resize(n);
+    vy_.resize(n);
+    ttl_.resize(n);
+    max_ttl_.resize(n);
+    effect_.resize(n);
+    size_.resize(n);
+}
+
+void ParticleHandler::resetParticles() { resize_(0); }
+
+bool ParticleHandler::isOnScreen_(int x, int y) {
+    return !Game::VIEWPORT ||
+           Game::VIEWPORT->isPointInView(x, y, ON_SCREEN_MARGIN);
+}
+
+int ParticleHandler::findEffect(const std::string &name) const {
+    return effects_.find(name);
+}
+
+size_t ParticleHandler::size() const { return x_.size(); }
+int ParticleHandler::getDrawCalls() const { return draw_calls_; }
+ParticleBudget &ParticleHandler::getBudget() { return budget_; }
@@ -1,87 +1,158 @@
 #ifndef PARTICLEHANDLER_H
 #define PARTICLEHANDLER_H
 
-#include "particle.h"
+#include "../rendering/renderobject.h"
+#include "../threading/workerpool.h"
+#include "particlebudget.h"
+#include "particleeffects.h"
+#include "rng.h"
+#include "SDL2/SDL.h"
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
-static const SDL_Color DEFAULT_PARTICLE_COLOR = SDL_Color{230, 185, 20, 255};
-static const double DEFAULT_EXPLOSION_SPEED = 0.5f;
-static const int DEFAULT_PARTICLE_LIFESPAN = 200;
+static const char *const DEFAULT_EFFECTS_FILE = "effects.ini";
 
-class PhysicsEngine;
 class RenderEngine;
-class ParticleHandler {
+
+///
+/// \brief The ParticleHandler class simulates and renders all particles.
+///
+/// Particles are not individual objects. Their state is stored as a structure
+/// of arrays and updated in one loop, dead particles are compacted by moving
+/// the later particles into their slots. Rendering buckets the particles by
+/// effect and lifetime step and records a single point batch per bucket.
+///
+/// The update is split into chunks that run on a worker pool, each chunk
+/// uses its own random stream.
+///
+/// What particles look like is described by ParticleEffect descriptors,
+/// loaded from an effects file at startup. Emitters only pick an effect.
+///
+/// Emission is limited by a ParticleBudget, every emission asks for its whole
+/// amount at once and is scaled down as a unit.
+///
+class ParticleHandler : public RenderObject {
   public:
     typedef std::shared_ptr<ParticleHandler> Ptr;
-    ParticleHandler(PhysicsEngine *physicsEngine, RenderEngine *renderEngine);
+
+    /// Number of particles updated as one parallel work item
+    static const size_t CHUNK_SIZE = 4096;
 
     ///
-    /// \brief Updates and deletes particles that are no longer alive
+    /// \brief Creates the particle handler
+    /// \param renderEngine RenderEngine instance
+    /// \param effects_path particle effects file, built-in effects are used
+    /// for effects missing from the file
     ///
-    void update();
+    explicit ParticleHandler(RenderEngine *renderEngine,
+                             const std::string &effects_path =
+                                 DEFAULT_EFFECTS_FILE);
 
     ///
-    /// \brief Creates a single particle with the given
-    /// location and speed
-    /// \param direction_rad particle direction
-    /// \param launch_speed particle launch speed
-    /// \param vx launcher initial speed in x direction
-    /// \param vy launcher initial speed in y direction
-    /// \param x launch coordinate x
-    /// \param y launch coordinate y
-    /// \param max_lifespan maximum lifespan of the particle
+    /// \brief Updates and deletes particles that are no longer alive
     ///
-    void createParticle(double direction_rad, double launch_speed, double vx,
-                        double vy, int x, int y, int max_lifespan,
-                        SDL_Color color = DEFAULT_PARTICLE_COLOR,
-                        ParticleSize size = ParticleSize::PARTICLE_M);
+    void update();
 
     ///
-    /// \brief Creates a burst of particles
-    /// \param heading particle direction
-    /// \param speed particle launch speed
+    /// \brief Emits particles of an effect
+    /// \param effect effect id, a ParticleEffectId or a value returned by
+    /// findEffect()
     /// \param x launch coordinate x
     /// \param y launch coordinate y
+    /// \param heading burst direction, ignored by explosions
     /// \param vx launcher initial speed in x direction
     /// \param vy launcher initial speed in y direction
-    /// \param amount number of particles
-    /// \param spread spread angle
-    /// \param max_lifespan maximum lifespan of particles
-    /// \param normal sets the spread to be normally distributed
+    /// \param amount_scale multiplier for the effect particle amount
+    /// \param delay_ms time since the emission was requested, particles are
+    /// advanced by this much to compensate for deferred spawning
     ///
-    void createParticleBurst(double heading, double speed, int x, int y,
-                             double vx, double vy, int amount, double spread,
-                             int max_lifespan,
-                             SDL_Color color = DEFAULT_PARTICLE_COLOR,
-                             bool normal = true);
+    void emit(int effect, int x, int y, double heading, double vx, double vy,
+              double amount_scale = 1.0, double delay_ms = 0.0);
 
     ///
-    /// \brief Creates an explosion of particles
-    /// \param x launch coordinate x
-    /// \param y launch coordinate y
-    /// \param speed launch speed
-    /// \param vx launcher initial speed in x direction
-    /// \param vy launcher initial speed in y direction
-    /// \param amount number of particles
-    /// \param max_lifespan maximum lifespan of particles
-    /// \param color particle color
+    /// \brief Finds an effect by name
+    /// \param name effect name
+    /// \return effect id, -1 if not found
     ///
-    void createParticleExplosion(int x, int y, double speed, double vx,
-                                 double vy, int amount, int max_lifespan,
-                                 SDL_Color color = DEFAULT_PARTICLE_COLOR);
+    [[nodiscard]] int findEffect(const std::string &name) const;
 
     ///
     /// \brief resetParticle deletes all particles
     ///
     void resetParticles();
 
-    // Data structure for storing particles
-    std::vector<Particle::Ptr> particles;
+    ///
+    /// \brief Renders all live particles in world coordinates
+    /// \param offset_x viewport offset x, unused
+    /// \param offset_y viewport offset y, unused
+    ///
+    void render(int offset_x, int offset_y) override;
+
+    /// Number of live particles
+    [[nodiscard]] size_t size() const;
+
+    /// Number of point batches recorded by the last render
+    [[nodiscard]] int getDrawCalls() const;
+
+    ///
+    /// \brief Gets the governor limiting particle emission
+    /// \return particle budget
+    ///
+    ParticleBudget &getBudget();
 
   private:
-    PhysicsEngine *physicsEngine_ = nullptr;
-    RenderEngine *renderEngine_ = nullptr;
+    ///
+    /// \brief Simulates particles [first, last), dead particles are marked
+    /// by their time to live and compacted afterwards
+    ///
+    void updateRange_(size_t first, size_t last, float delta, float decay,
+                      FastRng &rng);
+
+    ///
+    /// \brief Appends a particle without consulting the budget
+    ///
+    void spawn_(int effect, double direction_rad, double launch_speed,
+                double vx, double vy, int x, int y, ParticleSize size,
+                double delay_ms);
+
+    ///
+    /// \brief Moves particle src into slot dst
+    ///
+    void move_(size_t dst, size_t src);
+
+    ///
+    /// \brief Resizes all particle arrays
+    ///
+    void resize_(size_t n);
+
+    ///
+    /// \brief Checks if an emitter position is visible
+    ///
+    static bool isOnScreen_(int x, int y);
+
+    // Particle state, one entry per particle
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> vx_;
+    std::vector<float> vy_;
+    std::vector<float> ttl_;
+    std::vector<float> max_ttl_;
+    std::vector<uint16_t> effect_;
+    std::vector<uint8_t> size_; // size at spawn
+
+    ParticleEffectLibrary effects_;
+
+    ParticleBudget budget_;
+    WorkerPool pool_;
+
+    // Per-frame random streams are derived from the seed and frame counter
+    uint64_t seed_;
+    uint64_t frame_ = 0;
+
+    Uint32 last_update_;
+    int draw_calls_ = 0;
 };
 
 #endif // PARTICLEHANDLER_H
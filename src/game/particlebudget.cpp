@@ -0,0 +1,84 @@
+#include "particlebudget.h"
+#include "../blaster.h"
+#include <algorithm>
+
+// Weight of the newest sample in the smoothed frame time
+static const double FRAME_TIME_SMOOTHING = 0.1;
+
+// Emission scale adjustment per frame
+static const double SCALE_DECREASE = 0.85;
+static const double SCALE_RECOVERY = 0.02;
+static const double SCALE_MIN = 0.05;
+
+// Share of the scaled emission granted to emitters outside the viewport
+// while the budget is tight
+static const double OFF_SCREEN_FACTOR = 0.25;
+
+ParticleBudget::ParticleBudget(size_t max_live, size_t max_spawn_per_frame)
+    : max_live_(max_live), max_spawn_per_frame_(max_spawn_per_frame),
+      target_ms_(TICKS_PER_FRAME) {}
+
+void ParticleBudget::beginFrame(double frame_ms, size_t live) {
+#if DEBUG_PARTICLE_BUDGET
+    if (++frames_ % PARTICLE_BUDGET_REPORT_INTERVAL == 0)
+        LOG("Particle budget: %zu live, %zu requested, %zu granted, "
+            "%zu dropped, scale %.2f, frame %.1f ms",
+            metrics_.live, metrics_.requested, metrics_.granted,
+            metrics_.dropped, metrics_.scale, metrics_.frame_ms);
+#endif
+
+    double smoothed = metrics_.frame_ms == 0.0
+                          ? frame_ms
+                          : metrics_.frame_ms +
+                                FRAME_TIME_SMOOTHING *
+                                    (frame_ms - metrics_.frame_ms);
+
+    // Back off quickly when over the target, recover slowly
+    if (smoothed > target_ms_)
+        scale_ = std::max(SCALE_MIN, scale_ * SCALE_DECREASE);
+    else
+        scale_ = std::min(1.0, scale_ + SCALE_RECOVERY);
+
+    spawned_ = 0;
+    metrics_ = Metrics{0, 0, 0, live, scale_, smoothed};
+}
+
+size_t ParticleBudget::grant(size_t requested, bool on_screen) {
+    if (requested == 0)
+        return 0;
+
+    size_t live = metrics_.live + spawned_;
+    size_t live_room = live < max_live_ ? max_live_ - live : 0;
+    size_t frame_room = spawned_ < max_spawn_per_frame_
+                            ? max_spawn_per_frame_ - spawned_
+                            : 0;
+
+    // Off-screen emitters only give way while the budget is tight, that is
+    // while the scale is reduced or the request would not fit under a cap
+    bool tight = scale_ < 1.0 || requested > std::min(live_room, frame_room);
+    double share = on_screen || !tight ? scale_ : scale_ * OFF_SCREEN_FACTOR;
+    auto granted = static_cast<size_t>(static_cast<double>(requested) * share);
+
+    // Visible emitters always get at least one particle
+    if (granted == 0 && on_screen)
+        granted = 1;
+
+    granted = std::min({granted, live_room, frame_room});
+
+    spawned_ += granted;
+    metrics_.requested += requested;
+    metrics_.granted += granted;
+    metrics_.dropped += requested - granted;
+    return granted;
+}
+
+const ParticleBudget::Metrics &ParticleBudget::getMetrics() const {
+    return metrics_;
+}
+
+void ParticleBudget::setTargetFrameTime(double ms) { target_ms_ = ms; }
+void ParticleBudget::setMaxLive(size_t max_live) { max_live_ = max_live; }
+
+void ParticleBudget::setMaxSpawnPerFrame(size_t max_spawn) {
+    max_spawn_per_frame_ = max_spawn;
+}
@@ -0,0 +1,75 @@
+#ifndef PARTICLEBUDGET_H
+#define PARTICLEBUDGET_H
+
+#include <cstddef>
+
+///
+/// \brief Frame-time-aware particle budget governor
+///
+/// Every particle emission asks the governor how many particles it may
+/// spawn. The grant is limited by
+///  - the live particle cap,
+///  - the per-frame spawn cap,
+///  - an emission scale that shrinks while the smoothed frame time exceeds
+///    the target frame time and slowly recovers when there is headroom,
+///  - an additional reduction for emitters outside the viewport, so that
+///    the visible density is preserved when the budget is tight.
+///
+class ParticleBudget {
+  public:
+    static const size_t DEFAULT_MAX_LIVE = 60000;
+    static const size_t DEFAULT_MAX_SPAWN_PER_FRAME = 6000;
+
+    ///
+    /// \brief Decisions of the governor, reset at the start of every frame
+    ///
+    struct Metrics {
+        size_t requested;  // particles requested during the frame
+        size_t granted;    // particles granted during the frame
+        size_t dropped;    // particles denied during the frame
+        size_t live;       // live particles at the start of the frame
+        double scale;      // emission scale used for the frame
+        double frame_ms;   // smoothed frame time
+    };
+
+    ParticleBudget(size_t max_live = DEFAULT_MAX_LIVE,
+                   size_t max_spawn_per_frame = DEFAULT_MAX_SPAWN_PER_FRAME);
+
+    ///
+    /// \brief Starts a new frame
+    /// \param frame_ms duration of the last frame in ms
+    /// \param live number of live particles
+    ///
+    void beginFrame(double frame_ms, size_t live);
+
+    ///
+    /// \brief Asks for permission to spawn particles
+    /// \param requested number of particles the emitter wants
+    /// \param on_screen whether the emitter is visible
+    /// \return number of particles the emitter may spawn
+    ///
+    size_t grant(size_t requested, bool on_screen = true);
+
+    /// Decisions of the current frame
+    [[nodiscard]] const Metrics &getMetrics() const;
+
+    /// Sets the frame time the governor aims for
+    void setTargetFrameTime(double ms);
+
+    /// Sets the live particle cap
+    void setMaxLive(size_t max_live);
+
+    /// Sets the per-frame spawn cap
+    void setMaxSpawnPerFrame(size_t max_spawn);
+
+  private:
+    size_t max_live_;
+    size_t max_spawn_per_frame_;
+    double target_ms_;
+    double scale_ = 1.0;
+    size_t spawned_ = 0;
+    Metrics metrics_ = Metrics{0, 0, 0, 0, 1.0, 0.0};
+    unsigned int frames_ = 0;
+};
+
+#endif // PARTICLEBUDGET_H
@@ -0,0 +1,182 @@
+#include "particleeffects.h"
+#include "../blaster.h"
+#include "../config/INIReader.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+static const char *EFFECT_SECTION_PREFIX = "effect.";
+
+namespace {
+
+///
+/// \brief Bakes color keyframes into the lookup table
+///
+void bakeColors(ParticleEffect &e, const std::vector<SDL_Color> &keys) {
+    const int n = ParticleEffect::LUT_SIZE;
+    for (int i = 0; i < n; i++) {
+        if (keys.size() == 1) {
+            e.colors[i] = keys[0];
+            continue;
+        }
+
+        double pos = static_cast<double>(i) / (n - 1) * (keys.size() - 1);
+        auto k = std::min(static_cast<size_t>(pos), keys.size() - 2);
+        double t = pos - k;
+        const SDL_Color &a = keys[k];
+        const SDL_Color &b = keys[k + 1];
+        auto lerp = [t](Uint8 from, Uint8 to) {
+            return static_cast<Uint8>(from + (to - from) * t + 0.5);
+        };
+        e.colors[i] = SDL_Color{lerp(a.r, b.r), lerp(a.g, b.g),
+                                lerp(a.b, b.b), lerp(a.a, b.a)};
+    }
+}
+
+///
+/// \brief Bakes size keyframes into the lookup table
+///
+void bakeSizes(ParticleEffect &e, const std::vector<uint8_t> &keys) {
+    const int n = ParticleEffect::LUT_SIZE;
+    for (int i = 0; i < n; i++) {
+        size_t k = static_cast<size_t>(i) * keys.size() / n;
+        e.sizes[i] = keys[k];
+    }
+}
+
+///
+/// \brief Parses "r g b [a], r g b [a], ..."
+///
+std::vector<SDL_Color> parseColorCurve(const std::string &s) {
+    std::vector<SDL_Color> keys;
+    std::stringstream ss(s);
+    std::string key;
+    while (std::getline(ss, key, ',')) {
+        int r, g, b, a = 255;
+        if (sscanf(key.c_str(), "%d %d %d %d", &r, &g, &b, &a) >= 3)
+            keys.push_back(SDL_Color{
+                static_cast<Uint8>(std::clamp(r, 0, 255)),
+                static_cast<Uint8>(std::clamp(g, 0, 255)),
+                static_cast<Uint8>(std::clamp(b, 0, 255)),
+                static_cast<Uint8>(std::clamp(a, 0, 255))});
+    }
+    return keys;
+}
+
+///
+/// \brief Parses "M M S ..."
+///
+std::vector<uint8_t> parseSizeCurve(const std::string &s) {
+    std::vector<uint8_t> keys;
+    std::stringstream ss(s);
+    std::string key;
+    while (ss >> key)
+        keys.push_back(key == "M" || key == "m" ? PARTICLE_M : PARTICLE_S);
+    return keys;
+}
+
+ParticleEffect makeEffect(const char *name, EffectShape shape, int amount,
+                          double speed, double spread, int lifespan,
+                          SDL_Color from, SDL_Color to, const char *sizes) {
+    ParticleEffect e;
+    e.name = name;
+    e.shape = shape;
+    e.amount = amount;
+    e.speed = speed;
+    e.spread = spread;
+    e.lifespan = lifespan;
+    bakeColors(e, {from, to});
+    bakeSizes(e, parseSizeCurve(sizes));
+    return e;
+}
+
+} // namespace
+
+ParticleEffectLibrary::ParticleEffectLibrary() {
+    // Built-in effects, in ParticleEffectId order. Colors fade by
+    // (-40, -50, +70) and M particles break down after roughly 80 ms.
+    effects_ = {
+        makeEffect("thrust_outer", EFFECT_BURST, 30, 0.5, 0.6, 130,
+                   SDL_Color{255, 180, 10, 255}, SDL_Color{215, 130, 80, 255},
+                   "M M M M M S S S"),
+        makeEffect("thrust_inner", EFFECT_BURST, 15, 0.5, 0.3, 80,
+                   SDL_Color{255, 255, 10, 255}, SDL_Color{215, 205, 80, 255},
+                   "M"),
+        makeEffect("muzzle_flash", EFFECT_BURST, 20, 0.5, 0.05, 80,
+                   SDL_Color{230, 185, 20, 255}, SDL_Color{190, 135, 90, 255},
+                   "M"),
+        makeEffect("ship_explosion", EFFECT_EXPLOSION, 200, 0.5, 0.0, 200,
+                   SDL_Color{230, 185, 20, 255}, SDL_Color{190, 135, 90, 255},
+                   "M M M S S S S S"),
+        makeEffect("asteroid_explosion", EFFECT_EXPLOSION, 10, 0.5, 0.0, 200,
+                   SDL_Color{230, 185, 20, 255}, SDL_Color{190, 135, 90, 255},
+                   "M M M S S S S S"),
+    };
+}
+
+bool ParticleEffectLibrary::load(const std::string &path) {
+    INIReader reader(path);
+    if (reader.ParseError() != 0) {
+        LOG("Could not read %s, using built-in particle effects",
+            path.c_str());
+        return false;
+    }
+
+    const std::string prefix = EFFECT_SECTION_PREFIX;
+    for (const auto &section : reader.Sections()) {
+        if (section.compare(0, prefix.size(), prefix) != 0)
+            continue;
+
+        std::string name = section.substr(prefix.size());
+        int id = find(name);
+        if (id < 0) {
+            ParticleEffect e = effects_[EFFECT_MUZZLE_FLASH];
+            e.name = name;
+            effects_.push_back(e);
+            id = static_cast<int>(effects_.size() - 1);
+        }
+
+        // Unspecified keys keep the built-in or default values
+        ParticleEffect &e = effects_[id];
+        std::string shape = reader.Get(section, "shape", "");
+        if (shape == "burst")
+            e.shape = EFFECT_BURST;
+        else if (shape == "explosion")
+            e.shape = EFFECT_EXPLOSION;
+
+        e.amount = static_cast<int>(
+            reader.GetInteger(section, "amount", e.amount));
+        e.speed = reader.GetReal(section, "speed", e.speed);
+        e.spread = reader.GetReal(section, "spread", e.spread);
+        e.normal = reader.GetBoolean(section, "normal", e.normal);
+        e.lifespan = std::max(1, static_cast<int>(reader.GetInteger(
+                                     section, "lifespan", e.lifespan)));
+        e.volatility = static_cast<int>(
+            reader.GetInteger(section, "volatility", e.volatility));
+        e.large_share = reader.GetReal(section, "large_share", e.large_share);
+
+        auto colors = parseColorCurve(reader.Get(section, "color_curve", ""));
+        if (!colors.empty())
+            bakeColors(e, colors);
+
+        auto sizes = parseSizeCurve(reader.Get(section, "size_curve", ""));
+        if (!sizes.empty())
+            bakeSizes(e, sizes);
+    }
+
+    return true;
+}
+
+int ParticleEffectLibrary::find(const std::string &name) const {
+    for (size_t i = 0; i < effects_.size(); i++) {
+        if (effects_[i].name == name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+const ParticleEffect &ParticleEffectLibrary::get(int id) const {
+    return effects_[id];
+}
+
+size_t ParticleEffectLibrary::size() const { return effects_.size(); }
@@ -0,0 +1,106 @@
+#ifndef PARTICLEEFFECTS_H
+#define PARTICLEEFFECTS_H
+
+#include "SDL2/SDL.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum ParticleSize { PARTICLE_S, PARTICLE_M };
+
+///
+/// \brief Built-in effects, always present in the library
+///
+enum ParticleEffectId {
+    EFFECT_THRUST_OUTER,
+    EFFECT_THRUST_INNER,
+    EFFECT_MUZZLE_FLASH,
+    EFFECT_SHIP_EXPLOSION,
+    EFFECT_ASTEROID_EXPLOSION,
+    _effect_builtin_max
+};
+
+///
+/// \brief Emission pattern of an effect
+///
+enum EffectShape {
+    EFFECT_BURST,    // particles within a spread around a heading
+    EFFECT_EXPLOSION // particles evenly around the emitter
+};
+
+///
+/// \brief Descriptor of a particle effect
+///
+/// Color and size over the lifetime of a particle are baked into lookup
+/// tables of LUT_SIZE steps when the effect is loaded, so that the particle
+/// update and rendering only index the tables.
+///
+struct ParticleEffect {
+    static const int LUT_SIZE = 8;
+
+    std::string name;
+    EffectShape shape = EFFECT_BURST;
+    int amount = 20;        // particles per emission
+    double speed = 0.5;     // launch speed
+    double spread = 0.05;   // burst spread angle in radians
+    bool normal = true;     // normally distributed burst spread
+    int lifespan = 200;     // maximum particle lifetime in ms
+    int volatility = 0;     // chance (0-100) of random momentum per update
+    double large_share = 1.0 / 3; // share of PARTICLE_M particles
+
+    SDL_Color colors[LUT_SIZE];
+    uint8_t sizes[LUT_SIZE]; // largest ParticleSize at each step
+};
+
+///
+/// \brief Collection of particle effects
+///
+/// The library always holds the built-in effects. load() overrides them or
+/// adds new effects from an ini file where every [effect.<name>] section
+/// describes one effect:
+///
+///     [effect.thrust_outer]
+///     shape = burst          ; burst or explosion
+///     amount = 30
+///     speed = 0.5
+///     spread = 0.6
+///     normal = true
+///     lifespan = 130
+///     volatility = 0
+///     large_share = 0.33
+///     color_curve = 255 180 10, 215 130 80   ; r g b [a] keyframes
+///     size_curve = M M M M M S S S           ; M or S keyframes
+///
+/// Color keyframes are interpolated linearly over the particle lifetime,
+/// size keyframes are stepped.
+///
+class ParticleEffectLibrary {
+  public:
+    ParticleEffectLibrary();
+
+    ///
+    /// \brief Loads effect descriptors from an ini file. Missing files are
+    /// not an error, the built-in effects are kept in that case.
+    /// \param path effects file path
+    /// \return true if the file was read
+    ///
+    bool load(const std::string &path);
+
+    ///
+    /// \brief Finds an effect by name
+    /// \param name effect name
+    /// \return effect id, -1 if not found
+    ///
+    [[nodiscard]] int find(const std::string &name) const;
+
+    /// Gets an effect by id
+    [[nodiscard]] const ParticleEffect &get(int id) const;
+
+    /// Number of effects
+    [[nodiscard]] size_t size() const;
+
+  private:
+    std::vector<ParticleEffect> effects_;
+};
+
+#endif // PARTICLEEFFECTS_H
@@ -1,5 +1,6 @@
 #ifndef RNG_H
 #define RNG_H
+#include <cstdint>
 #include <random>
 static std::random_device rd;
 static std::mt19937 gen(rd());
@@ -46,4 +47,47 @@ static T random_int_in_range(int lo, int hi,
     return static_cast<T>(0);
 }
 
+///
+/// \brief Small, fast xorshift64* generator for hot loops.
+///
+/// Unlike the functions above the generator has no shared state, so every
+/// thread or work chunk can own an independently seeded stream.
+///
+class FastRng {
+  public:
+    ///
+    /// \brief Creates a generator, seeds are scrambled with splitmix64 so
+    /// that consecutive seeds give unrelated streams
+    /// \param seed stream seed
+    ///
+    explicit FastRng(uint64_t seed) {
+        seed += 0x9E3779B97F4A7C15ull;
+        seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ull;
+        seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBull;
+        state_ = (seed ^ (seed >> 31)) | 1;
+    }
+
+    /// Next 64 bit random value
+    uint64_t next() {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return state_ * 0x2545F4914F6CDD1Dull;
+    }
+
+    /// Random integer in [0, n)
+    int nextInt(int n) {
+        uint64_t r = (next() >> 32) * static_cast<uint64_t>(n);
+        return static_cast<int>(r >> 32);
+    }
+
+    /// Random double in [0, 1)
+    double nextDouble() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+  private:
+    uint64_t state_;
+};
+
 #endif // RNG_H
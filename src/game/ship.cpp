@@ -39,7 +39,7 @@ Ship::Ship(PhysicsEngine *physicsEngine,
     spawn_cooldown_ = SDL_GetTicks();
 
     // Create ship chassis
-    body.setRenderLayer(TOP_RENDER_LAYER_IDX);
+    body.setRenderLayer(WORLD_TOP_RENDER_LAYER_IDX);
     body.init(renderEngine,
               calculateChassis_(x_initial, y_initial),
               x_initial, y_initial);
@@ -134,22 +134,20 @@ void Ship::createParticles_() {
 
     double opp_direction_rad = heading_rad_ + PI;
 
-    SDL_Point bottom_right = body.outline[bottom_right_corner_idx_];
-    SDL_Point bottom_left = body.outline[bottom_left_corner_idx_];
+    SDL_Point *outline = body.getOutline();
+    SDL_Point bottom_right = outline[bottom_right_corner_idx_];
+    SDL_Point bottom_left = outline[bottom_left_corner_idx_];
 
     int x_exhaust = (bottom_left.x + bottom_right.x) / 2;
     int y_exhaust = (bottom_left.y + bottom_right.y) / 2;
 
-    int amount_outer = 30 * g_timescale;
-    int amount_inner = 15 * g_timescale;
-
-    particleHandler_->createParticleBurst(
-        opp_direction_rad, particleSpeed_, x_exhaust, y_exhaust, getVelX(),
-        getVelY(), amount_outer, 0.6f, 130, SDL_Color{255, 180, 10, 255});
-
-    particleHandler_->createParticleBurst(
-        opp_direction_rad, particleSpeed_, x_exhaust, y_exhaust, getVelX(),
-        getVelY(), amount_inner, 0.3f, 80, SDL_Color{255, 255, 10, 255});
+    // Exhaust amount follows the frame time
+    particleHandler_->emit(EFFECT_THRUST_OUTER, x_exhaust, y_exhaust,
+                           opp_direction_rad, getVelX(), getVelY(),
+                           g_timescale);
+    particleHandler_->emit(EFFECT_THRUST_INNER, x_exhaust, y_exhaust,
+                           opp_direction_rad, getVelX(), getVelY(),
+                           g_timescale);
 }
 
 void Ship::updateTimeAlive_() {
@@ -169,7 +167,7 @@ void Ship::shoot(BulletHandler *bHandler) {
     if ((SDL_GetTicks() - spawn_cooldown_) < 500)
         return;
 
-    SDL_Point top = body.outline[top_corner_idx_];
+    SDL_Point top = body.getOutline()[top_corner_idx_];
     activeWeapon_->shoot(bHandler, particleHandler_, heading_rad_, top.x,
                          top.y);
 }
@@ -198,9 +196,8 @@ void Ship::collision() {
         if (lives_ == 0) {
             alive = false;
             body.setRendering(false);
-            particleHandler_->createParticleExplosion(
-                getPosX(), getPosY(), DEFAULT_EXPLOSION_SPEED, getVelX(),
-                getVelY(), 200, DEFAULT_PARTICLE_LIFESPAN);
+            particleHandler_->emit(EFFECT_SHIP_EXPLOSION, getPosX(),
+                                   getPosY(), 0.0, getVelX(), getVelY());
         }
     }
 }
@@ -230,10 +227,11 @@ int Ship::getLives() { return lives_; }
 /// PROTOTYPE for multiplayer purposes
 std::vector<std::string> Ship::getOutline_() {
     std::vector<std::string> out;
+    SDL_Point *outline = body.getOutline();
 
     for (int i = 0; i < 6; ++i) {
-        out.push_back(std::to_string(body.outline[i].x));
-        out.push_back(std::to_string(body.outline[i].y));
+        out.push_back(std::to_string(outline[i].x));
+        out.push_back(std::to_string(outline[i].y));
     }
 
     return out;
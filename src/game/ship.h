@@ -154,9 +154,8 @@ class Ship : public PhysicsObject, public Entity {
     // Spawn cooldown to avoid accidental shooting
     Uint32 spawn_cooldown_ = 0;
 
-    // Ship particle speed and particlehandler instance
+    // Particlehandler instance
     ParticleHandler *particleHandler_;
-    const double particleSpeed_ = 0.5;
 
     // Renderengine instance
     RenderEngine *renderEngine_;
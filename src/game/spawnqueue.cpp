@@ -0,0 +1,64 @@
+#include "spawnqueue.h"
+#include "../blaster.h"
+#include <utility>
+
+SpawnQueue g_spawn_queue;
+
+SpawnQueue::SpawnQueue(size_t budget_per_frame)
+    : budget_per_frame_(budget_per_frame) {}
+
+void SpawnQueue::push(size_t count, size_t cost, SpawnFn fn) {
+    if (count == 0)
+        return;
+
+    requests_.push_back(
+        Request{std::move(fn), SDL_GetTicks(), count, 0, cost > 0 ? cost : 1});
+    depth_ += count;
+    if (depth_ > max_depth_)
+        max_depth_ = depth_;
+}
+
+void SpawnQueue::update() {
+    Uint32 now = SDL_GetTicks();
+    size_t spent = 0;
+    size_t spawned = 0;
+
+    while (!requests_.empty()) {
+        Request &r = requests_.front();
+        auto delay = static_cast<double>(now - r.ticks);
+
+        while (r.next < r.count) {
+            if (spawned > 0 && spent + r.cost > budget_per_frame_)
+                break;
+            r.fn(r.next++, delay);
+            spent += r.cost;
+            spawned++;
+        }
+
+        if (r.next < r.count)
+            break;
+        requests_.pop_front();
+    }
+
+    depth_ -= spawned;
+    spawned_last_frame_ = spawned;
+
+#if DEBUG_SPAWN_QUEUE
+    if (++frames_ % SPAWN_QUEUE_REPORT_INTERVAL == 0)
+        LOG("Spawn queue: depth %zu, max depth %zu, spawned %zu last frame",
+            depth_, max_depth_, spawned_last_frame_);
+#endif
+}
+
+void SpawnQueue::clear() {
+    requests_.clear();
+    depth_ = 0;
+}
+
+size_t SpawnQueue::getDepth() const { return depth_; }
+size_t SpawnQueue::getMaxDepth() const { return max_depth_; }
+size_t SpawnQueue::getSpawnedLastFrame() const { return spawned_last_frame_; }
+
+void SpawnQueue::setBudgetPerFrame(size_t budget) {
+    budget_per_frame_ = budget;
+}
@@ -0,0 +1,85 @@
+#ifndef SPAWNQUEUE_H
+#define SPAWNQUEUE_H
+
+#include "SDL2/SDL.h"
+#include <cstddef>
+#include <deque>
+#include <functional>
+
+///
+/// \brief Amortized spawning of bursts
+///
+/// Large bursts (weapon volleys, explosions) are pushed as requests of
+/// several items. update() materializes the queued items in request order
+/// until the per-frame spawn budget is used up, so a burst is spread over a
+/// few frames instead of stalling a single one. Every item is spawned with
+/// the time it spent in the queue, which the spawn function uses to advance
+/// the spawned objects to where they would be had they been spawned
+/// immediately.
+///
+class SpawnQueue {
+  public:
+    static const size_t DEFAULT_BUDGET_PER_FRAME = 1500;
+
+    ///
+    /// \brief Spawns a single item
+    /// \param index item index within the request
+    /// \param delay_ms time the item spent in the queue
+    ///
+    typedef std::function<void(size_t index, double delay_ms)> SpawnFn;
+
+    explicit SpawnQueue(size_t budget_per_frame = DEFAULT_BUDGET_PER_FRAME);
+
+    ///
+    /// \brief Queues a burst
+    /// \param count number of items
+    /// \param cost budget cost of a single item, roughly the number of
+    /// objects it creates
+    /// \param fn spawn function called once per item
+    ///
+    void push(size_t count, size_t cost, SpawnFn fn);
+
+    ///
+    /// \brief Spawns queued items within the per-frame budget. At least one
+    /// item is spawned per frame so that expensive items make progress.
+    ///
+    void update();
+
+    ///
+    /// \brief Drops all queued items
+    ///
+    void clear();
+
+    /// Number of items waiting to be spawned
+    [[nodiscard]] size_t getDepth() const;
+
+    /// Largest queue depth seen
+    [[nodiscard]] size_t getMaxDepth() const;
+
+    /// Number of items spawned by the last update
+    [[nodiscard]] size_t getSpawnedLastFrame() const;
+
+    /// Sets the budget spent per frame
+    void setBudgetPerFrame(size_t budget);
+
+  private:
+    struct Request {
+        SpawnFn fn;
+        Uint32 ticks;  // request time
+        size_t count;  // total items
+        size_t next;   // next item to spawn
+        size_t cost;   // cost per item
+    };
+
+    std::deque<Request> requests_;
+    size_t budget_per_frame_;
+    size_t depth_ = 0;
+    size_t max_depth_ = 0;
+    size_t spawned_last_frame_ = 0;
+    unsigned int frames_ = 0;
+};
+
+/// Spawn queue of the game thread
+extern SpawnQueue g_spawn_queue;
+
+#endif // SPAWNQUEUE_H
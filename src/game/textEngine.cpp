@@ -1,31 +1,22 @@
 #include "textEngine.h"
 #include "../game.h"
-#include "../resources/FreeSans.h"
+#include "../memory/alloctracker.h"
 
 TextEngine::TextEngine(RenderEngine *renderEngine)
-    : RenderObject(renderEngine), r_(255), b_(255), g_(255), a_(255) {}
+    : RenderObject(renderEngine, HUD_RENDER_LAYER_IDX), r_(255), b_(255),
+      g_(255), a_(255) {}
 
 TextEngine::TextEngine(RenderEngine *renderEngine,
                        int xpos, int ypos, int font_size)
-    : RenderObject(renderEngine), r_(255), b_(255), g_(255), a_(255) {
+    : RenderObject(renderEngine, HUD_RENDER_LAYER_IDX), r_(255), b_(255),
+      g_(255), a_(255) {
     setFontSize(font_size);
     setPosition(xpos, ypos);
 }
 
-TextEngine::~TextEngine() {
-    TTF_CloseFont(font_);
-    SDL_DestroyTexture(texture_);
-    SDL_FreeSurface(surface_);
-    SDL_RWclose(io_);
-}
-
 void TextEngine::setFontSize(int size) {
-    io_ = SDL_RWFromMem(FreeSans::getBytes(), FreeSans::getSize());
-    font_ = TTF_OpenFontRW(io_, 0, size);
-
-    if (font_ == nullptr) {
-        LOG("Font loading failed");
-    }
+    atlas_ = g_font_cache.get(size, renderEngine_->getCommandBuffer());
+    layout_();
 }
 
 void TextEngine::setColor(Uint8 r, Uint8 b, Uint8 g, Uint8 a) {
@@ -40,22 +31,34 @@ void TextEngine::setPosition(int xpos, int ypos) {
     y_ = ypos;
 }
 
-void TextEngine::setText(std::string text) {
+void TextEngine::setText(std::string_view text) {
+    ALLOC_SCOPE(ALLOC_TEXT);
 
     // Stop if the new text does not bring any changes
     if (text_ == text)
         return;
 
-    SDL_Color color = {r_, g_, b_, // color
-                       a_};        // alpha
-
-    SDL_FreeSurface(surface_);
-    SDL_DestroyTexture(texture_);
+    // Reuse the capacity of the stored string, text may not be terminated
+    text_.assign(text.data(), text.size());
+    layout_();
+}
 
-    surface_ = TTF_RenderText_Solid(font_, text.c_str(), color);
-    texture_ = SDL_CreateTextureFromSurface(Game::RENDERER, surface_);
+void TextEngine::layout_() {
+    glyph_src_.clear();
+    glyph_dst_.clear();
+    if (atlas_ == nullptr)
+        return;
 
-    text_ = text;
+    int pen_x = 0;
+    for (char c : text_) {
+        int glyph = GlyphAtlas::glyphIndex(c);
+        const SDL_Rect &src = atlas_->glyphs[glyph];
+        if (src.w > 0 && src.h > 0) {
+            glyph_src_.push_back(src);
+            glyph_dst_.push_back(SDL_Rect{pen_x, 0, src.w, src.h});
+        }
+        pen_x += atlas_->advances[glyph];
+    }
 }
 
 void TextEngine::setProgressBar(int progress, int max, int width,
@@ -74,9 +77,12 @@ void TextEngine::setProgressBar(int progress, int max, int width,
 }
 
 void TextEngine::render(int offset_x, int offset_y) {
-    int texW = 0;
-    int texH = 0;
-    SDL_QueryTexture(texture_, nullptr, nullptr, &texW, &texH);
-    position_ = {x_, y_, texW, texH};
-    SDL_RenderCopy(Game::RENDERER, texture_, nullptr, &position_);
+    if (atlas_ == nullptr)
+        return;
+
+    SDL_Color color = {r_, g_, b_, // color
+                       a_};        // alpha
+    renderEngine_->getCommandBuffer().drawQuads(
+        layer_, atlas_->texture, color, glyph_src_.data(), glyph_dst_.data(),
+        static_cast<int>(glyph_src_.size()), x_, y_);
 }
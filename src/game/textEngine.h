@@ -2,11 +2,17 @@
 #define TEXTENGINE_H
 
 #include "../rendering/renderobject.h"
+#include "fontcache.h"
 #include "SDL2/SDL.h"
-#include "SDL2/SDL_ttf.h"
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
+///
+/// \brief The TextEngine class draws a line of text from the glyph atlas of
+/// its font size. Changing the text only lays out glyph quads.
+///
 class TextEngine : public RenderObject {
   public:
     typedef std::shared_ptr<TextEngine> Ptr;
@@ -26,7 +32,6 @@ class TextEngine : public RenderObject {
     /// \param font_size font size
     ///
     TextEngine(RenderEngine *renderEngine, int xpos, int ypos, int font_size);
-    ~TextEngine();
 
     ///
     /// \brief Sets text position
@@ -54,7 +59,7 @@ class TextEngine : public RenderObject {
     /// \brief Sets text content
     /// \param text string to display
     ///
-    void setText(std::string text);
+    void setText(std::string_view text);
 
     ///
     /// \brief Constructs a progress bar
@@ -72,15 +77,18 @@ class TextEngine : public RenderObject {
     void render(int offset_x, int offset_y) override;
 
   private:
-    SDL_Surface *surface_ = nullptr;
-    SDL_Texture *texture_ = nullptr;
-    SDL_Color color_;
-    TTF_Font *font_ = nullptr;
-    SDL_Rect position_;
-    SDL_RWops *io_;
+    ///
+    /// \brief Rebuilds the glyph quads of the current text
+    ///
+    void layout_();
 
+    const GlyphAtlas *atlas_ = nullptr;
     std::string text_;
 
+    // Glyph quads, destinations are relative to the text position
+    std::vector<SDL_Rect> glyph_src_;
+    std::vector<SDL_Rect> glyph_dst_;
+
     // Position
     int x_;
     int y_;
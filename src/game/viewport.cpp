@@ -58,8 +58,17 @@ SDL_Rect *Viewport::get() {
     return vp_;
 }
 
-bool Viewport::isPointInView(int x, int y) {
-    // TODO
+bool Viewport::isPointInView(int x, int y, int margin) {
+    return x >= offset_x_ - margin && x < offset_x_ + SCREEN_RES_W + margin &&
+           y >= offset_y_ - margin && y < offset_y_ + SCREEN_RES_H + margin;
 }
 
 
+
+bool Viewport::isRectInView(int min_x, int min_y, int max_x, int max_y,
+                            int margin) {
+    return max_x >= offset_x_ - margin &&
+           min_x < offset_x_ + SCREEN_RES_W + margin &&
+           max_y >= offset_y_ - margin &&
+           min_y < offset_y_ + SCREEN_RES_H + margin;
+}
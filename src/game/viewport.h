@@ -38,7 +38,26 @@ class Viewport {
     ///
     SDL_Rect *get();
 
-    bool isPointInView(int x, int y);
+    ///
+    /// \brief Checks if a world point is visible
+    /// \param x world coordinate x
+    /// \param y world coordinate y
+    /// \param margin extra distance around the screen counted as visible
+    /// \return true if the point is in view
+    ///
+    bool isPointInView(int x, int y, int margin = 0);
+
+    ///
+    /// \brief Checks if a world bounding box overlaps the screen
+    /// \param min_x bounding box left edge
+    /// \param min_y bounding box top edge
+    /// \param max_x bounding box right edge
+    /// \param max_y bounding box bottom edge
+    /// \param margin extra distance around the screen counted as visible
+    /// \return true if any part of the box is in view
+    ///
+    bool isRectInView(int min_x, int min_y, int max_x, int max_y,
+                      int margin = 0);
 
   private:
     int offset_x_ = 0;
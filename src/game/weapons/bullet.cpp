@@ -12,51 +12,53 @@
 Bullet::~Bullet() {}
 
 /// Initialization
-Bullet::Bullet(double direction_initial, double v_initial, double x_initial,
-               double y_initial, double vx, double vy,
-               RenderEngine *renderEngine, PhysicsEngine *physicsEngine,
-               Entity* owner) :
-   PhysicsObject(physicsEngine, 2.0, x_initial, y_initial, true, -1.0f,
-                    false),
-    Entity(owner,false, BULLET) {
+Bullet::Bullet(RenderEngine *renderEngine, PhysicsEngine *physicsEngine)
+    : PhysicsObject(physicsEngine, 2.0, 0, 0, true, -1.0f, false),
+      Entity(false, BULLET) {
 
-    // Set collision properties
-    setCollidable(true);
+    // Set collision properties, collisions are enabled on launch
+    setCollidable(false);
+    setParked(true);
+    setSimulated(false);
     ENABLE_COLLISION(ASTEROID);
     ENABLE_COLLISION(SHIP);
 
-    double vx_total = v_initial * cos(direction_initial) + vx;
-    double vy_total = v_initial * sin(direction_initial) + vy;
-    setSpeedXY(vx_total, vy_total);
-    alive = true;
-
-    body_.init(renderEngine, getShape_(x_initial, y_initial), x_initial, y_initial);
+    body_.init(renderEngine, getShape_(0, 0), 0, 0);
     body_.setColor(SDL_Color{255, 51, 51, 255});
     body_.setRenderType(POINT);
+    body_.setRendering(false);
 }
 
-Bullet::Bullet(int x_initial, int y_initial, int vx, int vy,
-               RenderEngine *renderEngine, PhysicsEngine *physicsEngine,
-               Entity* owner)
-    : PhysicsObject(physicsEngine, 2.0, x_initial, y_initial, true, -1.0f,
-                    false),
-    Entity(owner, false, BULLET) {
+void Bullet::launch(double direction_initial, double v_initial,
+                    double x_initial, double y_initial, double vx, double vy,
+                    Entity *owner) {
+    resetPhysicsState(x_initial, y_initial);
+    setSimulated(true);
+    setParked(false);
+    double vx_total = v_initial * cos(direction_initial) + vx;
+    double vy_total = v_initial * sin(direction_initial) + vy;
+    setSpeedXY(vx_total, vy_total);
 
-    // Set collision properties
+    setOwner(owner);
     setCollidable(true);
-    ENABLE_COLLISION(ASTEROID);
-    ENABLE_COLLISION(SHIP);
-
-    setSpeedXY(vy, vx);
     alive = true;
 
-    body_.init(renderEngine, getShape_(x_initial, y_initial), x_initial, y_initial);
-    body_.setColor(SDL_Color{255, 51, 51, 255});
-    body_.setRenderType(POINT);
+    body_.moveAbsolute(x_initial, y_initial);
+    body_.setRendering(true);
+}
+
+void Bullet::retire() {
+    alive = false;
+    setCollidable(false);
+    body_.setRendering(false);
+
+    // Leave the entity snapshots and the physics step until launched again
+    setParked(true);
+    setSimulated(false);
 }
 
-std::vector<SDL_Point> Bullet::getShape_(int x, int y) {
-    std::vector<SDL_Point> points = {SDL_Point{x, y - 1}, SDL_Point{x - 1, y},
+FrameVector<SDL_Point> Bullet::getShape_(int x, int y) {
+    FrameVector<SDL_Point> points = {SDL_Point{x, y - 1}, SDL_Point{x - 1, y},
                                      SDL_Point{x + 1, y}, SDL_Point{x, y + 1},
                                      SDL_Point{x, y}};
 
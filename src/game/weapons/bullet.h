@@ -5,6 +5,7 @@
 #include "../../rendering/renderobject.h"
 #include "../graphics.h"
 #include "../entity.h"
+#include "../../memory/framearena.h"
 #include "SDL2/SDL.h"
 #include <memory>
 
@@ -14,22 +15,44 @@ class Bullet : public PhysicsObject, public Entity {
 
   private:
     static const int pixels = 5;
-    std::vector<SDL_Point> getShape_(int x, int y);
+    FrameVector<SDL_Point> getShape_(int x, int y);
     Polygon body_;
 
     Polygon *getBody() override;
     void collisionWith(Entity *e) override;
 
   public:
-    Bullet(double direction_initial, double v_initial, double x_initial,
-           double y_initial, double vx, double vy, RenderEngine *renderEngine,
-           PhysicsEngine *physicsEngine, Entity* owner);
-    Bullet(int x_initial, int y_initial, int vx, int vy,
-           RenderEngine *renderEngine, PhysicsEngine *physicsEngine,
-           Entity* owner);
+    ///
+    /// \brief Constructs an inactive bullet. Bullets are pooled by the
+    /// BulletHandler and brought to life with launch().
+    /// \param renderEngine RenderEngine instance
+    /// \param physicsEngine PhysicsEngine instance
+    ///
+    Bullet(RenderEngine *renderEngine, PhysicsEngine *physicsEngine);
     ~Bullet();
+
+    ///
+    /// \brief Activates the bullet with the given launch parameters
+    /// \param direction_initial launch direction in radians
+    /// \param v_initial launch speed
+    /// \param x_initial launch coordinate x
+    /// \param y_initial launch coordinate y
+    /// \param vx launcher speed in x direction
+    /// \param vy launcher speed in y direction
+    /// \param owner entity firing the bullet
+    ///
+    void launch(double direction_initial, double v_initial, double x_initial,
+                double y_initial, double vx, double vy, Entity *owner);
+
+    ///
+    /// \brief Deactivates the bullet so that it neither collides, moves nor
+    /// renders until launched again. The bullet is parked and left out of
+    /// the entity snapshots.
+    ///
+    void retire();
+
     void update();
-    bool alive;
+    bool alive = false;
 };
 
 #endif
@@ -32,15 +32,10 @@ void DoubleShotgun::shoot(BulletHandler *bHandler, ParticleHandler *paHandler,
             double speed_d = (rand() % 2 - 1) * 0.1;
             // Spreading shot
             spread_angles = calc_spread_angles(direction_rad, has_shot);
-            bHandler->addBullet(Bullet::Ptr(
-                new Bullet(spread_angles[0], shot_speed_ - speed_d, x, y, vx,
-                           vy, renderEngine_, physicsEngine_, (Entity*)physicsOwner_)));
-            bHandler->addBullet(Bullet::Ptr(
-                new Bullet(spread_angles[1], shot_speed_ - speed_d, x, y, vx,
-                           vy, renderEngine_, physicsEngine_, (Entity*)physicsOwner_)));
-            bHandler->addBullet(Bullet::Ptr(
-                new Bullet(spread_angles[2], shot_speed_ - speed_d, x, y, vx,
-                           vy, renderEngine_, physicsEngine_, (Entity*)physicsOwner_)));
+            BulletSpan volley = bHandler->addBullets(spread_angles.size());
+            for (size_t i = 0; i < spread_angles.size(); i++)
+                volley[i]->launch(spread_angles[i], shot_speed_ - speed_d, x,
+                                  y, vx, vy, owner_);
 
             // Flash
             createParticles(paHandler, spread_angles[0], x, y);
@@ -57,14 +52,14 @@ void DoubleShotgun::shoot(BulletHandler *bHandler, ParticleHandler *paHandler,
 }
 
 // Spread helper function for calculating rads
-std::vector<double> DoubleShotgun::calc_spread_angles(double angle_rad,
-                                                      bool alternate_gun) {
+std::array<double, 3> DoubleShotgun::calc_spread_angles(double angle_rad,
+                                                        bool alternate_gun) {
     // First shot spread in rad
     double twist = 0.1f;
     if (alternate_gun) {
         twist = -twist;
     }
-    std::vector<double> three_angles = {angle_rad, angle_rad - twist,
-                                        angle_rad - 2 * twist};
+    std::array<double, 3> three_angles = {angle_rad, angle_rad - twist,
+                                          angle_rad - 2 * twist};
     return three_angles;
 }
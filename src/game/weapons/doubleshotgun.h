@@ -1,7 +1,7 @@
 #ifndef DOUBLESHOTGUN_H
 #define DOUBLESHOTGUN_H
 
-#include <vector>
+#include <array>
 
 #include "../particleHandler.h"
 #include "weapon.h"
@@ -22,8 +22,8 @@ class DoubleShotgun : public Weapon {
                double direction_rad, int x, int y) override;
 
   private:
-    std::vector<double> spread_angles;
-    std::vector<double> calc_spread_angles(double angle_rad, bool altering);
+    std::array<double, 3> spread_angles;
+    std::array<double, 3> calc_spread_angles(double angle_rad, bool altering);
     // alternating shooting side
     bool has_shot = false;
 };
@@ -1,26 +1,35 @@
 #include "mininuke.h"
+#include "../spawnqueue.h"
 
 void MiniNuke::shoot(BulletHandler *bHandler, ParticleHandler *paHandler,
                      double /*direction_rad*/, int x, int y) {
     if ((!isReloading()) && (getShotsLeft() > 0)) {
 
         if ((SDL_GetTicks() - last_shot_start_ticks_) > fire_rate_cooldown_) {
+            // The volley is spawned over a few frames, every bullet with its
+            // muzzle flash. Positions are advanced by the queueing delay so
+            // the nuke looks and hits the same as when spawned at once.
             int nuke_particles = 200;
-            for (int i = 0; i < nuke_particles; i++) {
-                double angle = (double)i / nuke_particles * 2 * PI;
-                double speed = shot_speed_;
-                if (i % 2)
-                    speed *= 0.9; // every other nuke particle has slighty
-                                  // slower speed
-                if (i % 3)
-                    speed *= 0.8; // every third is even slower because it looks
-                                  // even cooler
-                bHandler->addBullet(Bullet::Ptr(new Bullet(
-                    angle, speed, x, y, physicsOwner_->getVelX(),
-                               physicsOwner_->getVelY(),
-                    renderEngine_, physicsEngine_, (Entity*)physicsOwner_)));
-                createParticles(paHandler, angle, x, y);
-            }
+            double shot_speed = shot_speed_;
+            double vx = physicsOwner_->getVelX();
+            double vy = physicsOwner_->getVelY();
+            Entity *owner = owner_;
+            g_spawn_queue.push(
+                nuke_particles, 21, [=](size_t i, double delay_ms) {
+                    double angle = (double)i / nuke_particles * 2 * PI;
+                    double speed = shot_speed;
+                    if (i % 2)
+                        speed *= 0.9; // every other nuke particle has slighty
+                                      // slower speed
+                    if (i % 3)
+                        speed *= 0.8; // every third is even slower because it
+                                      // looks even cooler
+                    double bx = x + (speed * cos(angle) + vx) * delay_ms;
+                    double by = y + (speed * sin(angle) + vy) * delay_ms;
+                    bHandler->addBullet(angle, speed, bx, by, vx, vy, owner);
+                    paHandler->emit(EFFECT_MUZZLE_FLASH, x, y, angle, vx, vy,
+                                    1.0, delay_ms);
+                });
 
             // Update weapon status
             last_shot_start_ticks_ = SDL_GetTicks();
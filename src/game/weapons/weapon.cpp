@@ -18,10 +18,9 @@ void Weapon::shoot(BulletHandler *bHandler, ParticleHandler *paHandler,
         if ((SDL_GetTicks() - last_shot_start_ticks_) > fire_rate_cooldown_) {
             // variable speed
             double dSpeed = (rand() % 2) * 0.05f;
-            bHandler->addBullet(Bullet::Ptr(new Bullet(
-                direction_rad, shot_speed_ - dSpeed, x, y,
-                           physicsOwner_->getVelX(), physicsOwner_->getVelY(),
-                renderEngine_, physicsEngine_, owner_)));
+            bHandler->addBullet(direction_rad, shot_speed_ - dSpeed, x, y,
+                                physicsOwner_->getVelX(),
+                                physicsOwner_->getVelY(), owner_);
             createParticles(paHandler, direction_rad, x, y);
             last_shot_start_ticks_ = SDL_GetTicks();
             shots_in_magazine_--;
@@ -35,9 +34,8 @@ void Weapon::shoot(BulletHandler *bHandler, ParticleHandler *paHandler,
 
 void Weapon::createParticles(ParticleHandler *paHandler, double direction_rad,
                              int x, int y) {
-    paHandler->createParticleBurst(direction_rad, 0.5f, x, y,
-                                   physicsOwner_->getVelX(),
-                                   physicsOwner_->getVelY(), 20, 0.05f, 80);
+    paHandler->emit(EFFECT_MUZZLE_FLASH, x, y, direction_rad,
+                    physicsOwner_->getVelX(), physicsOwner_->getVelY());
 }
 
 void Weapon::reload() {
@@ -107,7 +105,7 @@ int Weapon::getShotsLeft() {
     return ret;
 }
 
-std::string Weapon::getName() { return weapon_name_; }
+const std::string &Weapon::getName() const { return weapon_name_; }
 
 void Weapon::reset() {
     stopReloading();
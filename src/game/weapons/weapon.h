@@ -57,7 +57,7 @@ class Weapon {
     /// \brief Get name of the weapon
     /// \return weapon name
     ///
-    std::string getName();
+    const std::string &getName() const;
 
     ///
     /// \brief Resets weapon state
@@ -0,0 +1,248 @@
+#include "alloctracker.h"
+#include "SDL2/SDL.h"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static thread_local AllocSubsystem t_scope = ALLOC_OTHER;
+
+AllocScope::AllocScope(AllocSubsystem subsystem) : previous_(t_scope) {
+    t_scope = subsystem;
+}
+
+AllocScope::~AllocScope() { t_scope = previous_; }
+
+AllocSubsystem AllocScope::current() { return t_scope; }
+
+const char *AllocTracker::subsystemName(AllocSubsystem subsystem) {
+    switch (subsystem) {
+    case ALLOC_PHYSICS:
+        return "physics";
+    case ALLOC_PARTICLES:
+        return "particles";
+    case ALLOC_ASTEROIDS:
+        return "asteroids";
+    case ALLOC_RENDERING:
+        return "rendering";
+    case ALLOC_TEXT:
+        return "text";
+    case ALLOC_NETWORKING:
+        return "networking";
+    default:
+        return "other";
+    }
+}
+
+#if TRACK_ALLOCATIONS
+
+namespace {
+
+// Every tracked block is prefixed with a header holding the requested size
+// and the subsystem it was charged to. The header size keeps the default
+// new/malloc alignment intact.
+struct alignas(16) Header {
+    size_t size;
+    uint32_t subsystem;
+    uint32_t magic;
+};
+static_assert(sizeof(Header) == 16, "allocation header must be 16 bytes");
+const uint32_t HEADER_MAGIC = 0xB1A57E12;
+
+struct AtomicCounters {
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<int64_t> live_bytes{0};
+};
+
+AtomicCounters counters[_alloc_subsystem_max];
+AllocTracker::Counters last_frame[_alloc_subsystem_max];
+AllocTracker::Counters window[_alloc_subsystem_max];
+uint64_t frame = 0;
+FILE *csv = nullptr;
+
+SDL_malloc_func sdl_malloc = nullptr;
+SDL_calloc_func sdl_calloc = nullptr;
+SDL_realloc_func sdl_realloc = nullptr;
+SDL_free_func sdl_free = nullptr;
+
+inline void *track(Header *h, size_t size) {
+    AllocSubsystem s = t_scope;
+    h->size = size;
+    h->subsystem = s;
+    h->magic = HEADER_MAGIC;
+    counters[s].allocs.fetch_add(1, std::memory_order_relaxed);
+    counters[s].bytes.fetch_add(size, std::memory_order_relaxed);
+    counters[s].live_bytes.fetch_add(static_cast<int64_t>(size),
+                                     std::memory_order_relaxed);
+    return h + 1;
+}
+
+inline Header *untrack(void *ptr) {
+    Header *h = static_cast<Header *>(ptr) - 1;
+    assert(h->magic == HEADER_MAGIC);
+    counters[h->subsystem].live_bytes.fetch_sub(
+        static_cast<int64_t>(h->size), std::memory_order_relaxed);
+    return h;
+}
+
+void *trackedNew(size_t size) {
+    auto *h = static_cast<Header *>(std::malloc(sizeof(Header) + size));
+    if (!h)
+        return nullptr;
+    return track(h, size);
+}
+
+void trackedDelete(void *ptr) {
+    if (ptr)
+        std::free(untrack(ptr));
+}
+
+// SDL memory hooks, wrapping the functions SDL was using before install()
+void *SDLCALL hookMalloc(size_t size) {
+    auto *h = static_cast<Header *>(sdl_malloc(sizeof(Header) + size));
+    if (!h)
+        return nullptr;
+    return track(h, size);
+}
+
+void *SDLCALL hookCalloc(size_t nmemb, size_t size) {
+    // Like calloc, refuse sizes that do not fit instead of wrapping around
+    if (size != 0 && nmemb > SIZE_MAX / size)
+        return nullptr;
+    size_t bytes = nmemb * size;
+    void *ptr = hookMalloc(bytes);
+    if (ptr)
+        memset(ptr, 0, bytes);
+    return ptr;
+}
+
+void *SDLCALL hookRealloc(void *mem, size_t size) {
+    if (!mem)
+        return hookMalloc(size);
+
+    // A failed realloc leaves the original block and its record untouched,
+    // it is only untracked once it has been replaced
+    Header *old = static_cast<Header *>(mem) - 1;
+    assert(old->magic == HEADER_MAGIC);
+    uint32_t old_subsystem = old->subsystem;
+    size_t old_size = old->size;
+    auto *h = static_cast<Header *>(sdl_realloc(old, sizeof(Header) + size));
+    if (!h)
+        return nullptr;
+    counters[old_subsystem].live_bytes.fetch_sub(
+        static_cast<int64_t>(old_size), std::memory_order_relaxed);
+    return track(h, size);
+}
+
+void SDLCALL hookFree(void *mem) {
+    if (mem)
+        sdl_free(untrack(mem));
+}
+
+} // namespace
+
+void *operator new(size_t size) {
+    void *ptr = trackedNew(size);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return trackedNew(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    return trackedNew(size);
+}
+
+void operator delete(void *ptr) noexcept { trackedDelete(ptr); }
+void operator delete[](void *ptr) noexcept { trackedDelete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { trackedDelete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { trackedDelete(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    trackedDelete(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    trackedDelete(ptr);
+}
+
+void AllocTracker::install(const char *csv_path) {
+    SDL_GetMemoryFunctions(&sdl_malloc, &sdl_calloc, &sdl_realloc, &sdl_free);
+    if (SDL_SetMemoryFunctions(hookMalloc, hookCalloc, hookRealloc,
+                               hookFree) < 0)
+        LOG("Hooking SDL memory functions failed: %s", SDL_GetError());
+
+    csv = fopen(csv_path, "w");
+    if (csv)
+        fprintf(csv, "frame,subsystem,allocs,bytes,live_bytes\n");
+    else
+        LOG("Could not open allocation report %s", csv_path);
+
+    LOG("Allocation tracking enabled, reporting to %s", csv_path);
+}
+
+void AllocTracker::endFrame() {
+    for (int i = 0; i < _alloc_subsystem_max; i++) {
+        Counters &c = last_frame[i];
+        c.allocs = counters[i].allocs.exchange(0, std::memory_order_relaxed);
+        c.bytes = counters[i].bytes.exchange(0, std::memory_order_relaxed);
+        c.live_bytes = counters[i].live_bytes.load(std::memory_order_relaxed);
+
+        window[i].allocs += c.allocs;
+        window[i].bytes += c.bytes;
+        window[i].live_bytes = c.live_bytes;
+
+        if (csv)
+            fprintf(csv, "%llu,%s,%llu,%llu,%lld\n",
+                    static_cast<unsigned long long>(frame),
+                    subsystemName(static_cast<AllocSubsystem>(i)),
+                    static_cast<unsigned long long>(c.allocs),
+                    static_cast<unsigned long long>(c.bytes),
+                    static_cast<long long>(c.live_bytes));
+    }
+
+    if (++frame % ALLOC_REPORT_INTERVAL == 0) {
+        LOG("Allocations per frame over the last %d frames:",
+            ALLOC_REPORT_INTERVAL);
+        for (int i = 0; i < _alloc_subsystem_max; i++) {
+            LOG("  %-10s %8.1f allocs %10.1f bytes %12lld live bytes",
+                subsystemName(static_cast<AllocSubsystem>(i)),
+                static_cast<double>(window[i].allocs) / ALLOC_REPORT_INTERVAL,
+                static_cast<double>(window[i].bytes) / ALLOC_REPORT_INTERVAL,
+                static_cast<long long>(window[i].live_bytes));
+            window[i] = Counters{0, 0, 0};
+        }
+    }
+}
+
+void AllocTracker::shutdown() {
+    if (csv) {
+        fclose(csv);
+        csv = nullptr;
+    }
+}
+
+AllocTracker::Counters AllocTracker::getLastFrame(AllocSubsystem subsystem) {
+    return last_frame[subsystem];
+}
+
+#else // TRACK_ALLOCATIONS
+
+void AllocTracker::install(const char *) {}
+void AllocTracker::endFrame() {}
+void AllocTracker::shutdown() {}
+
+AllocTracker::Counters AllocTracker::getLastFrame(AllocSubsystem) {
+    return Counters{0, 0, 0};
+}
+
+#endif // TRACK_ALLOCATIONS
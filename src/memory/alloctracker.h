@@ -0,0 +1,103 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#include "../blaster.h"
+#include <cstddef>
+#include <cstdint>
+
+///
+/// \brief Subsystems heap allocations can be attributed to
+///
+enum AllocSubsystem {
+    ALLOC_OTHER,
+    ALLOC_PHYSICS,
+    ALLOC_PARTICLES,
+    ALLOC_ASTEROIDS,
+    ALLOC_RENDERING,
+    ALLOC_TEXT,
+    ALLOC_NETWORKING,
+    _alloc_subsystem_max
+};
+
+///
+/// \brief Opt-in heap allocation tracker
+///
+/// When TRACK_ALLOCATIONS is enabled the global operator new/delete are
+/// replaced and SDL_malloc is hooked via SDL_SetMemoryFunctions. Every
+/// allocation is tagged with the innermost active AllocScope of the calling
+/// thread. Per frame allocation counts, allocated bytes and live bytes are
+/// written to a CSV file and periodically summarized in the log.
+///
+/// With TRACK_ALLOCATIONS disabled nothing is hooked and ALLOC_SCOPE expands
+/// to nothing.
+///
+namespace AllocTracker {
+
+///
+/// \brief Per subsystem counters
+///
+struct Counters {
+    uint64_t allocs;     // allocations during the frame
+    uint64_t bytes;      // bytes allocated during the frame
+    int64_t live_bytes;  // bytes currently allocated
+};
+
+///
+/// \brief Hooks SDL memory functions and opens the CSV report. Must be
+/// called before any other SDL function.
+/// \param csv_path report file path
+///
+extern void install(const char *csv_path = "alloc_report.csv");
+
+///
+/// \brief Closes the frame: snapshots and resets the per frame counters,
+/// appends them to the CSV report and logs a summary every
+/// ALLOC_REPORT_INTERVAL frames.
+///
+extern void endFrame();
+
+///
+/// \brief Flushes and closes the CSV report
+///
+extern void shutdown();
+
+///
+/// \brief Gets the counters of the last completed frame
+/// \param subsystem subsystem to query
+/// \return counters
+///
+extern Counters getLastFrame(AllocSubsystem subsystem);
+
+///
+/// \brief Returns printable subsystem name
+///
+extern const char *subsystemName(AllocSubsystem subsystem);
+
+} // namespace AllocTracker
+
+///
+/// \brief RAII helper tagging all allocations of the current thread with
+/// the given subsystem while in scope. Scopes nest, the innermost wins.
+///
+class AllocScope {
+  public:
+    explicit AllocScope(AllocSubsystem subsystem);
+    ~AllocScope();
+
+    AllocScope(const AllocScope &) = delete;
+    AllocScope &operator=(const AllocScope &) = delete;
+
+    /// Subsystem active on the calling thread
+    static AllocSubsystem current();
+
+  private:
+    AllocSubsystem previous_;
+};
+
+#if TRACK_ALLOCATIONS
+#define ALLOC_SCOPE(subsystem) AllocScope _alloc_scope_(subsystem)
+#else
+#define ALLOC_SCOPE(subsystem) (void)0
+#endif
+
+#endif // ALLOCTRACKER_H
@@ -0,0 +1,86 @@
+#include "framearena.h"
+#include <cstdint>
+#include <cstdio>
+#include <new>
+
+FrameArena g_frame_arena;
+
+FrameArena::FrameArena(size_t capacity) { addBlock_(capacity); }
+
+FrameArena::~FrameArena() {
+    for (auto &b : blocks_)
+        ::operator delete(b.data);
+}
+
+void FrameArena::addBlock_(size_t min_size) {
+    // Block list is reserved up front so that growing it during a frame
+    // does not count as a hidden allocation
+    if (blocks_.capacity() == blocks_.size())
+        blocks_.reserve(blocks_.size() + 8);
+
+    Block b{static_cast<char *>(::operator new(min_size)), min_size};
+    blocks_.push_back(b);
+    block_allocations_++;
+}
+
+void *FrameArena::allocate(size_t size, size_t align) {
+    if (size == 0)
+        size = 1;
+
+    while (true) {
+        Block &b = blocks_[current_];
+        auto base = reinterpret_cast<uintptr_t>(b.data);
+        uintptr_t aligned = (base + offset_ + align - 1) & ~(align - 1);
+        size_t start = aligned - base;
+
+        if (start + size <= b.size) {
+            used_ += (start - offset_) + size;
+            offset_ = start + size;
+            return b.data + start;
+        }
+
+        // Current block exhausted, continue in the next one or grow
+        if (current_ + 1 == blocks_.size()) {
+            size_t grow = blocks_.back().size;
+            addBlock_(size + align > grow ? size + align : grow);
+        }
+        current_++;
+        offset_ = 0;
+    }
+}
+
+void FrameArena::reset() {
+    if (used_ > high_watermark_)
+        high_watermark_ = used_;
+
+    // Merge overflow blocks so that the next frame of the same size fits
+    // into a single block without further allocations
+    if (blocks_.size() > 1) {
+        size_t total = getCapacity();
+        for (auto &b : blocks_)
+            ::operator delete(b.data);
+        blocks_.clear();
+        addBlock_(total);
+    }
+
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+size_t FrameArena::getUsed() const { return used_; }
+size_t FrameArena::getHighWatermark() const { return high_watermark_; }
+size_t FrameArena::getBlockAllocations() const { return block_allocations_; }
+
+size_t FrameArena::getCapacity() const {
+    size_t total = 0;
+    for (auto &b : blocks_)
+        total += b.size;
+    return total;
+}
+
+FrameString toFrameString(long long value) {
+    char buf[24];
+    int n = snprintf(buf, sizeof(buf), "%lld", value);
+    return FrameString(buf, static_cast<size_t>(n));
+}
@@ -0,0 +1,129 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+///
+/// \brief The FrameArena class is a linear (bump) allocator for short lived,
+/// per-tick temporaries.
+///
+/// Allocations are served by advancing a pointer inside a preallocated block.
+/// Individual deallocations are no-ops; all memory is reclaimed at once when
+/// reset() is called at the top of Game::advance. Anything allocated from the
+/// arena must therefore not outlive the frame it was created in.
+///
+/// If a frame requests more memory than the current block holds, an overflow
+/// block is allocated. On the next reset the blocks are merged into a single
+/// block large enough for the whole frame, so steady-state frames do not touch
+/// the heap at all.
+///
+/// The arena is not thread-safe and must only be used from the game thread.
+///
+class FrameArena {
+  public:
+    static const size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+    ~FrameArena();
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    ///
+    /// \brief Allocates memory from the arena
+    /// \param size number of bytes
+    /// \param align required alignment, must be a power of two
+    /// \return pointer to uninitialized memory, valid until the next reset
+    ///
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    ///
+    /// \brief Releases everything allocated since the last reset. Overflow
+    /// blocks are merged into one block sized for the largest frame seen.
+    ///
+    void reset();
+
+    /// Bytes handed out since the last reset
+    [[nodiscard]] size_t getUsed() const;
+
+    /// Largest number of bytes used by a single frame
+    [[nodiscard]] size_t getHighWatermark() const;
+
+    /// Total capacity of the arena blocks
+    [[nodiscard]] size_t getCapacity() const;
+
+    /// Number of heap allocations done by the arena itself since startup
+    [[nodiscard]] size_t getBlockAllocations() const;
+
+  private:
+    struct Block {
+        char *data;
+        size_t size;
+    };
+
+    void addBlock_(size_t min_size);
+
+    std::vector<Block> blocks_;
+    size_t current_ = 0; // index of the block being bumped
+    size_t offset_ = 0;  // bump offset within the current block
+    size_t used_ = 0;    // bytes used since last reset
+    size_t high_watermark_ = 0;
+    size_t block_allocations_ = 0;
+};
+
+/// Arena shared by all per-tick temporaries of the game thread
+extern FrameArena g_frame_arena;
+
+///
+/// \brief STL-compatible allocator adapter for FrameArena.
+///
+/// Containers using this allocator must be local to a single frame.
+///
+template <typename T> class FrameAllocator {
+  public:
+    typedef T value_type;
+
+    FrameAllocator() noexcept : arena_(&g_frame_arena) {}
+    explicit FrameAllocator(FrameArena *arena) noexcept : arena_(arena) {}
+
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U> &other) noexcept
+        : arena_(other.arena()) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, size_t) noexcept {
+        // Memory is reclaimed in bulk by FrameArena::reset
+    }
+
+    [[nodiscard]] FrameArena *arena() const noexcept { return arena_; }
+
+    template <typename U> bool operator==(const FrameAllocator<U> &o) const {
+        return arena_ == o.arena();
+    }
+
+    template <typename U> bool operator!=(const FrameAllocator<U> &o) const {
+        return arena_ != o.arena();
+    }
+
+  private:
+    FrameArena *arena_;
+};
+
+template <typename T> using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>
+    FrameString;
+
+///
+/// \brief Formats an integer into a frame-local string
+/// \param value value to format
+/// \return formatted string
+///
+extern FrameString toFrameString(long long value);
+
+#endif // FRAMEARENA_H
@@ -1,8 +1,10 @@
 #include "messagehandler.h"
 #include "buffers/schema_generated.h"
+#include "../memory/alloctracker.h"
 
 MessageHandler::MessageHandler(int port, int host_port, char *host_address,
                                MultiplayerRole multiplayerRole) {
+    ALLOC_SCOPE(ALLOC_NETWORKING);
     multiplayerRole_ = multiplayerRole;
     socket_.reset(new Socket());
     socket_->init(static_cast<uint16_t>(port), PACKET_SIZE);
@@ -17,10 +19,11 @@ std::vector<Blaster::Messages::Point>
 MessageHandler::getFlatOutline_(Polygon *source) {
     // Tranform ship outline to vector of "Point" structs
     std::vector<Blaster::Messages::Point> outline;
+    SDL_Point *points = source->getOutline();
     for (int i = 0; i < source->points; i++) {
         outline.push_back(
-            Blaster::Messages::Point{static_cast<int>(source->outline[i].x),
-                                     static_cast<int>(source->outline[i].x)});
+            Blaster::Messages::Point{static_cast<int>(points[i].x),
+                                     static_cast<int>(points[i].y)});
     }
 
     return outline;
@@ -32,6 +35,8 @@ Blaster::Messages::Color MessageHandler::getFlatColor_(Polygon *source) {
 }
 
 MessageBuffer MessageHandler::buildShipMessage(Ship *ship) {
+    ALLOC_SCOPE(ALLOC_NETWORKING);
+
     // Initialize builder (memory allocation will increase if needed)
     MessageBuffer builder(1024);
 
@@ -66,6 +71,7 @@ MessageBuffer MessageHandler::buildShipMessage(Ship *ship) {
 }
 
 void MessageHandler::send(uint8_t *data, unsigned int len) {
+    ALLOC_SCOPE(ALLOC_NETWORKING);
     send_mutex_.lock();
     send_buffer_.push(Msg{data, len});
     send_mutex_.unlock();
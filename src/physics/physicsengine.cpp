@@ -1,4 +1,5 @@
 #include "physicsengine.h"
+#include "../memory/alloctracker.h"
 
 PhysicsEngine::PhysicsEngine() {}
 
@@ -6,8 +7,10 @@ void PhysicsEngine::addObject(PhysicsObject *obj) { objects_.insert(obj); }
 
 void PhysicsEngine::removeObject(PhysicsObject *obj) { objects_.erase(obj); }
 
-void PhysicsEngine::step() {
+void PhysicsEngine::step(RenderCommandBuffer *debug) {
+    ALLOC_SCOPE(ALLOC_PHYSICS);
     for (auto obj : objects_) {
-        obj->calculatePhysics(FRICTION_DECAY, PHYSICS_VISUAL_DEBUG);
+        if (obj->isSimulated())
+            obj->calculatePhysics(FRICTION_DECAY, debug);
     }
 }
@@ -11,13 +11,19 @@ const static double FRICTION_DECAY = 0.005;
 /// physics when the engine function "step" is called
 ///
 class PhysicsObject;
+class RenderCommandBuffer;
 class PhysicsEngine {
   public:
     PhysicsEngine();
 
     void addObject(PhysicsObject *obj);
     void removeObject(PhysicsObject *obj);
-    void step();
+    ///
+    ///@brief Calculates the physics of all simulated objects
+    ///@param debug command buffer the physics debug graphics are recorded
+    ///into, nullptr to draw none
+    ///
+    void step(RenderCommandBuffer *debug = nullptr);
 
   private:
     std::set<PhysicsObject *> objects_;
@@ -1,6 +1,7 @@
 #include "physicsobject.h"
 #include "../game.h"
 #include "../game/graphics.h"
+#include "../rendering/rendercommandbuffer.h"
 #include <limits>
 #include <vector>
 
@@ -29,7 +30,8 @@ PhysicsObject::~PhysicsObject() {
         physicsEngine_->removeObject(this);
 }
 
-void PhysicsObject::calculatePhysics(double friction_decay, bool visual_debug) {
+void PhysicsObject::calculatePhysics(double friction_decay,
+                                     RenderCommandBuffer *debug) {
     // THIS FUNCTION SHOULD BE ONLY CALLED BY THE PHYSICS ENGINE
 
     // Calculate the new position
@@ -67,12 +69,12 @@ void PhysicsObject::calculatePhysics(double friction_decay, bool visual_debug) {
     E_kx_ = 0.5 * m_ * std::pow(vx_, 2);
     E_ky_ = 0.5 * m_ * std::pow(vy_, 2);
 
-    if (visual_debug) {
+    if (debug) {
         // LOG("mass: %.2f, x: %.2f, y: %.2f, vx: %.2f, vy: %.2f, ax:
         // %.2f, ay: %.2f, Fx: %.2f, Fy: %.2f, Time delta: %.2f",
         // m_, x_, y_, vx_, vy_, ax_, ay_,  (Fx_ + Fx_const_), (Fy_+ Fy_const_),
         // time_delta)
-        renderDebugPhysics();
+        renderDebugPhysics(*debug);
     }
 
     // Reset forces. This means that the game engine must set forces each frame
@@ -234,7 +236,7 @@ void PhysicsObject::resetPhysicsState(double x, double y) {
     ticks_ = SDL_GetTicks();
 }
 
-void PhysicsObject::renderDebugPhysics() {
+void PhysicsObject::renderDebugPhysics(RenderCommandBuffer &commands) {
     // Force vector and object radius circle
     SDL_Point force_vec[2] = {
         {static_cast<int>(x_), static_cast<int>(y_)},
@@ -249,13 +251,16 @@ void PhysicsObject::renderDebugPhysics() {
         circle[i].y = y_ + r_ * std::sin(i * 2 * PI / 16);
     }
 
-    SDL_SetRenderDrawColor(Game::RENDERER, 255, 0, 0, 255);
-    SDL_RenderDrawLines(Game::RENDERER, force_vec, 2);
-    SDL_RenderDrawLines(Game::RENDERER, circle, 17);
-    SDL_SetRenderDrawColor(Game::RENDERER, 255, 255, 0, 255);
-    SDL_RenderDrawLines(Game::RENDERER, velocity_vec, 2);
+    SDL_Color red{255, 0, 0, 255};
+    commands.drawLines(WORLD_TOP_RENDER_LAYER_IDX, red, force_vec, 2);
+    commands.drawLines(WORLD_TOP_RENDER_LAYER_IDX, red, circle, 17);
+    commands.drawLines(WORLD_TOP_RENDER_LAYER_IDX, SDL_Color{255, 255, 0, 255},
+                       velocity_vec, 2);
 }
 
+void PhysicsObject::setSimulated(bool simulated) { simulated_ = simulated; }
+bool PhysicsObject::isSimulated() const { return simulated_; }
+
 double PhysicsObject::getMass() { return m_; }
 double PhysicsObject::getPosX() { return x_; }
 double PhysicsObject::getPosY() { return y_; }
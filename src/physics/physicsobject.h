@@ -26,6 +26,7 @@
 ///limit direct access to the variables and avoid unnatural physics.
 ///
 class PhysicsEngine;
+class RenderCommandBuffer;
 class PhysicsObject {
   public:
     ///
@@ -45,8 +46,10 @@ class PhysicsObject {
     ///
     ///@brief Take a step in time and calculate new object physics. SHOULD BE
     ///ONLY CALLED BY THE PHYSICS ENGINE
+    ///@param debug command buffer debug graphics are recorded into, nullptr
+    ///to draw none
     ///
-    void calculatePhysics(double friction_decay, bool visual_debug);
+    void calculatePhysics(double friction_decay, RenderCommandBuffer *debug);
 
     ///
     ///@brief setRadius
@@ -119,9 +122,17 @@ class PhysicsObject {
     void resetPhysicsState(double x, double y);
 
     ///
-    ///@brief Render debug graphics for objects physics
+    ///@brief Records debug graphics for objects physics, in world
+    ///coordinates on the topmost world layer
     ///
-    void renderDebugPhysics();
+    void renderDebugPhysics(RenderCommandBuffer &commands);
+
+    ///
+    ///@brief Enables or disables the simulation of the object. Objects not
+    ///simulated stay registered but are skipped by the physics engine.
+    ///
+    void setSimulated(bool simulated);
+    bool isSimulated() const;
 
   public: // these are aimed for the use in inherited classes, as we'll avoid
           // giving direct access to the physics variables
@@ -162,6 +173,7 @@ class PhysicsObject {
     bool friction_decay_;
     double max_speed_;
     Uint32 ticks_;
+    bool simulated_ = true;
 
   private: // functions handled by PhysicsObject class only
     void checkBounds();
@@ -0,0 +1,66 @@
+#include "polygonlod.h"
+#include "../blaster.h"
+
+PolygonLod g_polygon_lod;
+
+// On-screen radii in pixels below which the levels are used, at medium
+// quality
+static const double POINT_RADIUS = 1.5;
+static const double OUTLINE_RADIUS = 4.0;
+static const double SIMPLIFIED_RADIUS = 12.0;
+
+LodLevel PolygonLod::select(double radius) const {
+    double pixels = radius * pixel_scale_;
+    if (pixels < POINT_RADIUS * threshold_scale_)
+        return LOD_POINT;
+    if (pixels < OUTLINE_RADIUS * threshold_scale_)
+        return LOD_OUTLINE;
+    if (pixels < SIMPLIFIED_RADIUS * threshold_scale_)
+        return LOD_SIMPLIFIED;
+    return LOD_FULL;
+}
+
+void PolygonLod::count(size_t full, size_t drawn) {
+    full_ += full;
+    drawn_ += drawn;
+}
+
+void PolygonLod::endFrame() {
+    last_saved_ = full_ > drawn_ ? full_ - drawn_ : 0;
+    last_drawn_ = drawn_;
+
+#if DEBUG_POLYGON_LOD
+    window_saved_ += last_saved_;
+    window_full_ += full_;
+    if (++frames_ % POLYGON_LOD_REPORT_INTERVAL == 0) {
+        LOG("Polygon LOD: %.1f of %.1f vertices saved per frame",
+            static_cast<double>(window_saved_) / POLYGON_LOD_REPORT_INTERVAL,
+            static_cast<double>(window_full_) / POLYGON_LOD_REPORT_INTERVAL);
+        window_saved_ = 0;
+        window_full_ = 0;
+    }
+#endif
+
+    full_ = 0;
+    drawn_ = 0;
+}
+
+void PolygonLod::setQuality(Quality quality) {
+    switch (quality) {
+    case QUALITY_LOW:
+        threshold_scale_ = 2.0;
+        break;
+    case QUALITY_MEDIUM:
+        threshold_scale_ = 1.0;
+        break;
+    default:
+        threshold_scale_ = 0.5;
+        break;
+    }
+}
+
+void PolygonLod::setPixelScale(double scale) { pixel_scale_ = scale; }
+
+size_t PolygonLod::getVerticesSaved() const { return last_saved_; }
+
+size_t PolygonLod::getVerticesDrawn() const { return last_drawn_; }
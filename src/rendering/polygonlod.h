@@ -0,0 +1,85 @@
+#ifndef POLYGONLOD_H
+#define POLYGONLOD_H
+
+#include "../blaster.h"
+#include <cstddef>
+
+///
+/// \brief Polygon detail levels, from most to least detailed
+///
+enum LodLevel {
+    LOD_FULL,       // full outline and fill
+    LOD_SIMPLIFIED, // every other outline point, outline and fill
+    LOD_OUTLINE,    // simplified outline only
+    LOD_POINT       // single point at the center
+};
+
+///
+/// \brief Picks polygon detail levels by on-screen size
+///
+/// The on-screen radius of a polygon is its radius times the pixel scale,
+/// which is the render scale of the screen including dynamic resolution.
+/// The radius thresholds of the levels are multiplied by a quality factor,
+/// low quality switches to coarser levels earlier.
+///
+/// Polygons report the vertices of their full detail and of the level they
+/// were drawn with, the difference is the saving of the frame.
+///
+class PolygonLod {
+  public:
+    ///
+    /// \brief Global quality settings
+    ///
+    enum Quality { QUALITY_LOW, QUALITY_MEDIUM, QUALITY_HIGH };
+
+    ///
+    /// \brief Selects a detail level
+    /// \param radius polygon radius in game coordinates
+    /// \return detail level
+    ///
+    [[nodiscard]] LodLevel select(double radius) const;
+
+    ///
+    /// \brief Counts the vertices of a rendered polygon
+    /// \param full vertices at full detail
+    /// \param drawn vertices recorded
+    ///
+    void count(size_t full, size_t drawn);
+
+    ///
+    /// \brief Closes the frame counters, called after rendering
+    ///
+    void endFrame();
+
+    /// Sets the quality setting
+    void setQuality(Quality quality);
+
+    /// Sets screen pixels per game coordinate unit
+    void setPixelScale(double scale);
+
+    /// Vertices saved by the last rendered frame
+    [[nodiscard]] size_t getVerticesSaved() const;
+
+    /// Vertices recorded by the last rendered frame
+    [[nodiscard]] size_t getVerticesDrawn() const;
+
+  private:
+    double threshold_scale_ = 1.0;
+    double pixel_scale_ = 1.0;
+
+    size_t full_ = 0;
+    size_t drawn_ = 0;
+    size_t last_saved_ = 0;
+    size_t last_drawn_ = 0;
+
+#if DEBUG_POLYGON_LOD
+    size_t window_saved_ = 0;
+    size_t window_full_ = 0;
+    unsigned int frames_ = 0;
+#endif
+};
+
+/// Polygon detail selection of the game thread
+extern PolygonLod g_polygon_lod;
+
+#endif // POLYGONLOD_H
@@ -0,0 +1,655 @@
+#include "rendercommandbuffer.h"
+#include "rendertrace.h"
+#include "softwarerasterizer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+
+// Sort key layout, from the most significant bit: layer (3 bits), primitive
+// (3 bits), colour or texture id (32 bits) and submission order (26 bits)
+const int SEQUENCE_BITS = 26;
+const uint64_t SEQUENCE_MASK = (uint64_t{1} << SEQUENCE_BITS) - 1;
+
+inline uint32_t packColor(SDL_Color c) {
+    return (static_cast<uint32_t>(c.r) << 24) |
+           (static_cast<uint32_t>(c.g) << 16) |
+           (static_cast<uint32_t>(c.b) << 8) | c.a;
+}
+
+inline int layerOf(uint64_t key) { return static_cast<int>(key >> 61); }
+
+inline SDL_Color unpackColor(uint32_t c) {
+    return SDL_Color{static_cast<Uint8>(c >> 24), static_cast<Uint8>(c >> 16),
+                     static_cast<Uint8>(c >> 8), static_cast<Uint8>(c)};
+}
+
+inline RenderPrimitive primitiveOf(uint64_t key) {
+    return static_cast<RenderPrimitive>((key >> 58) & 0x7);
+}
+
+inline uint32_t colorOf(uint64_t key) {
+    return static_cast<uint32_t>(key >> SEQUENCE_BITS);
+}
+
+// Cleared for good once the renderer rejects geometry, shared by all buffers
+// as they draw with the same renderer
+std::atomic<bool> geometry_supported{true};
+
+std::atomic<uint32_t> next_slot_id{0};
+
+#if DEBUG_RENDER_BATCHING
+// Buffers are flushed by a single thread
+RenderCommandBuffer::Stats window = {0, 0, 0, 0};
+unsigned int frames = 0;
+#endif
+
+} // namespace
+
+TextureSlot::TextureSlot() : id(next_slot_id.fetch_add(1)) {}
+
+uint64_t RenderCommandBuffer::key_(int layer, RenderPrimitive primitive,
+                                   uint32_t state) {
+    auto sequence = static_cast<uint64_t>(commands_.size()) & SEQUENCE_MASK;
+    return (static_cast<uint64_t>(layer & 0x7) << 61) |
+           (static_cast<uint64_t>(primitive) << 58) |
+           (static_cast<uint64_t>(state) << SEQUENCE_BITS) | sequence;
+}
+
+void RenderCommandBuffer::drawPoints(int layer, SDL_Color color,
+                                     const SDL_Point *points, int n,
+                                     int offset_x, int offset_y) {
+    if (n <= 0)
+        return;
+
+    auto first = static_cast<uint32_t>(points_.size());
+    for (int i = 0; i < n; i++)
+        points_.push_back(SDL_Point{points[i].x + offset_x,
+                                    points[i].y + offset_y});
+    commands_.push_back(
+        Command{key_(layer, PRIMITIVE_POINTS, packColor(color)), first,
+                static_cast<uint32_t>(n), 0, 0});
+}
+
+void RenderCommandBuffer::drawLines(int layer, SDL_Color color,
+                                    const SDL_Point *points, int n,
+                                    int offset_x, int offset_y) {
+    if (n <= 0)
+        return;
+
+    auto first = static_cast<uint32_t>(rects_.size());
+    if (n == 1)
+        rasterizeLine_(points[0].x + offset_x, points[0].y + offset_y,
+                       points[0].x + offset_x, points[0].y + offset_y);
+    for (int i = 0; i < n - 1; i++)
+        rasterizeLine_(points[i].x + offset_x, points[i].y + offset_y,
+                       points[i + 1].x + offset_x, points[i + 1].y + offset_y);
+    commands_.push_back(
+        Command{key_(layer, PRIMITIVE_RECTS, packColor(color)), first,
+                static_cast<uint32_t>(rects_.size() - first), 0, 0});
+}
+
+void RenderCommandBuffer::fillRects(int layer, SDL_Color color,
+                                    const SDL_Rect *rects, int n,
+                                    int offset_x, int offset_y) {
+    if (n <= 0)
+        return;
+
+    auto first = static_cast<uint32_t>(rects_.size());
+    for (int i = 0; i < n; i++)
+        rects_.push_back(SDL_Rect{rects[i].x + offset_x,
+                                  rects[i].y + offset_y, rects[i].w,
+                                  rects[i].h});
+    commands_.push_back(
+        Command{key_(layer, PRIMITIVE_RECTS, packColor(color)), first,
+                static_cast<uint32_t>(n), 0, 0});
+}
+
+#if HAS_RENDER_GEOMETRY
+void RenderCommandBuffer::drawTriangles(int layer, SDL_Color color,
+                                        const SDL_Point *vertices,
+                                        int n_vertices, const int *indices,
+                                        int n_indices, int offset_x,
+                                        int offset_y) {
+    if (n_vertices <= 0 || n_indices <= 0)
+        return;
+
+    auto first = static_cast<uint32_t>(vertices_.size());
+    auto first_index = static_cast<uint32_t>(indices_.size());
+    for (int i = 0; i < n_vertices; i++) {
+        vertices_.push_back(SDL_Vertex{
+            SDL_FPoint{static_cast<float>(vertices[i].x + offset_x),
+                       static_cast<float>(vertices[i].y + offset_y)},
+            color, SDL_FPoint{0.0f, 0.0f}});
+    }
+    indices_.insert(indices_.end(), indices, indices + n_indices);
+
+    // Colour is stored per vertex, all triangles of a layer share a key
+    commands_.push_back(Command{
+        key_(layer, PRIMITIVE_TRIANGLES, 0), first,
+        static_cast<uint32_t>(n_vertices), first_index,
+        static_cast<uint32_t>(n_indices)});
+}
+#endif
+
+bool RenderCommandBuffer::hasGeometry() const {
+#if HAS_RENDER_GEOMETRY
+    return geometry_supported.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif
+}
+
+void RenderCommandBuffer::copy(int layer, const TextureSlot::Ptr &slot,
+                               const SDL_Rect &dst) {
+    if (!slot)
+        return;
+
+    auto first = static_cast<uint32_t>(copies_.size());
+    copies_.push_back(Copy{slot, dst});
+    commands_.push_back(Command{
+        key_(layer, PRIMITIVE_COPY, 0), first, 1, 0, 0});
+}
+
+void RenderCommandBuffer::drawQuads(int layer, const TextureSlot::Ptr &slot,
+                                    SDL_Color color, const SDL_Rect *src,
+                                    const SDL_Rect *dst, int n, int offset_x,
+                                    int offset_y) {
+    if (!slot || n <= 0)
+        return;
+
+    auto first = static_cast<uint32_t>(quads_.size());
+    for (int i = 0; i < n; i++) {
+        quads_.push_back(Quad{src[i],
+                              SDL_Rect{dst[i].x + offset_x,
+                                       dst[i].y + offset_y, dst[i].w,
+                                       dst[i].h},
+                              color});
+    }
+    auto slot_index = static_cast<uint32_t>(quad_slots_.size());
+    quad_slots_.push_back(slot);
+    commands_.push_back(Command{key_(layer, PRIMITIVE_QUADS, slot->id), first,
+                                static_cast<uint32_t>(n), slot_index, 0});
+}
+
+void RenderCommandBuffer::setClearColor(SDL_Color color) {
+    clear_color_ = color;
+    clear_ = true;
+}
+
+void RenderCommandBuffer::setScaledTarget(const ScaledTarget &target) {
+    target_ = target;
+    has_target_ = true;
+}
+
+void RenderCommandBuffer::setCamera(int offset_x, int offset_y,
+                                    int screen_layer) {
+    camera_x_ = offset_x;
+    camera_y_ = offset_y;
+    screen_layer_ = screen_layer;
+}
+
+void RenderCommandBuffer::defer(RenderTask task) {
+    tasks_.push_back(std::move(task));
+}
+
+void RenderCommandBuffer::rasterizeLine_(int x0, int y0, int x1, int y1) {
+    // Bresenham, consecutive pixels along the major axis are merged into a
+    // single one pixel thick rectangle
+    int dx = std::abs(x1 - x0);
+    int dy = std::abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    bool x_major = dx >= dy;
+    int major = x_major ? dx : dy;
+    int minor = x_major ? dy : dx;
+    int err = major / 2;
+
+    int x = x0;
+    int y = y0;
+    int run_start = x_major ? x : y;
+    for (int i = 0;; i++) {
+        bool last = i == major;
+        bool minor_step = false;
+        if (!last) {
+            err -= minor;
+            if (err < 0) {
+                err += major;
+                minor_step = true;
+            }
+        }
+
+        if (last || minor_step) {
+            if (x_major)
+                rects_.push_back(SDL_Rect{std::min(run_start, x), y,
+                                          std::abs(x - run_start) + 1, 1});
+            else
+                rects_.push_back(SDL_Rect{x, std::min(run_start, y), 1,
+                                          std::abs(y - run_start) + 1});
+        }
+        if (last)
+            break;
+
+        if (x_major) {
+            x += sx;
+            if (minor_step)
+                y += sy;
+        } else {
+            y += sy;
+            if (minor_step)
+                x += sx;
+        }
+        if (minor_step)
+            run_start = x_major ? x : y;
+    }
+}
+
+void RenderCommandBuffer::runTasks(SDL_Renderer *renderer) {
+    for (auto &task : tasks_)
+        task(renderer);
+    tasks_.clear();
+}
+
+void RenderCommandBuffer::flush(SDL_Renderer *renderer) {
+    runTasks(renderer);
+
+    // Tasks may have started a capture or created the traced textures
+    if (trace_ && trace_->isCapturing())
+        writeTrace_();
+
+    std::sort(commands_.begin(), commands_.end(),
+              [](const Command &a, const Command &b) { return a.key < b.key; });
+
+    Stats stats = Stats{static_cast<int>(commands_.size()), 0, 0, 0};
+    bool has_color = false;
+    uint32_t current_color = 0;
+
+    // Render scale and viewport of the screen are restored by SDL when the
+    // target is reset
+    bool target_active = has_target_ && target_.texture->texture &&
+                         SDL_SetRenderTarget(renderer,
+                                             target_.texture->texture) == 0;
+    if (target_active)
+        SDL_RenderSetScale(renderer, target_.scale_x, target_.scale_y);
+
+    // World layers come first, the viewport of the screen or target is
+    // restored for the screen layers. The clear ignores the viewport.
+    bool camera_active = camera_x_ != 0 || camera_y_ != 0;
+    SDL_Rect screen_viewport =
+        camera_active ? applyCamera_(renderer) : SDL_Rect{0, 0, 0, 0};
+
+    if (clear_) {
+        SDL_SetRenderDrawColor(renderer, clear_color_.r, clear_color_.g,
+                               clear_color_.b, clear_color_.a);
+        SDL_RenderClear(renderer);
+        stats.state_changes++;
+    }
+
+    bool rasterizer_active = rasterizer_ && rasterizer_->begin(renderer);
+
+    size_t i = 0;
+    while (i < commands_.size()) {
+        // Commands up to j share layer, primitive and colour
+        uint64_t group = commands_[i].key >> SEQUENCE_BITS;
+        size_t j = i;
+        while (j < commands_.size() &&
+               (commands_[j].key >> SEQUENCE_BITS) == group)
+            j++;
+
+        int layer = layerOf(commands_[i].key);
+        RenderPrimitive primitive = primitiveOf(commands_[i].key);
+        bool textured =
+            primitive == PRIMITIVE_COPY || primitive == PRIMITIVE_QUADS;
+
+        // Rasterized primitives go below textures drawn after them and into
+        // the target they were drawn for
+        if (rasterizer_active &&
+            (textured || (target_active && layer >= target_.native_layer)))
+            stats.draw_calls +=
+                resolveRasterizer_(renderer, camera_active);
+
+        if (camera_active && layer >= screen_layer_) {
+            SDL_RenderSetViewport(renderer, &screen_viewport);
+            camera_active = false;
+        }
+        if (target_active && layer >= target_.native_layer) {
+            resolveTarget_(renderer);
+            target_active = false;
+            stats.draw_calls++;
+        }
+
+        if (rasterizer_active && !textured) {
+            rasterize_(i, j);
+            for (size_t k = i; k < j; k++)
+                stats.vertices += commands_[k].count;
+            i = j;
+            continue;
+        }
+
+        uint32_t color = colorOf(commands_[i].key);
+        if ((primitive == PRIMITIVE_RECTS || primitive == PRIMITIVE_POINTS) &&
+            (!has_color || color != current_color)) {
+            SDL_SetRenderDrawColor(renderer, (color >> 24) & 0xff,
+                                   (color >> 16) & 0xff, (color >> 8) & 0xff,
+                                   color & 0xff);
+            current_color = color;
+            has_color = true;
+            stats.state_changes++;
+        }
+
+        switch (primitive) {
+        case PRIMITIVE_TRIANGLES: {
+#if HAS_RENDER_GEOMETRY
+            merged_vertices_.clear();
+            merged_indices_.clear();
+            for (size_t k = i; k < j; k++) {
+                const Command &c = commands_[k];
+                auto base = static_cast<int>(merged_vertices_.size());
+                merged_vertices_.insert(merged_vertices_.end(),
+                                        vertices_.begin() + c.first,
+                                        vertices_.begin() + c.first + c.count);
+                for (uint32_t n = 0; n < c.index_count; n++)
+                    merged_indices_.push_back(
+                        indices_[c.first_index + n] + base);
+            }
+            if (SDL_RenderGeometry(renderer, nullptr, merged_vertices_.data(),
+                                   static_cast<int>(merged_vertices_.size()),
+                                   merged_indices_.data(),
+                                   static_cast<int>(merged_indices_.size())) <
+                0) {
+                LOG("Drawing geometry failed, falling back to spans: %s",
+                    SDL_GetError());
+                geometry_supported.store(false, std::memory_order_relaxed);
+            }
+            stats.vertices += merged_vertices_.size();
+            stats.draw_calls++;
+#endif
+            break;
+        }
+        case PRIMITIVE_POINTS: {
+            merged_points_.clear();
+            for (size_t k = i; k < j; k++) {
+                const Command &c = commands_[k];
+                merged_points_.insert(merged_points_.end(),
+                                      points_.begin() + c.first,
+                                      points_.begin() + c.first + c.count);
+            }
+            SDL_RenderDrawPoints(renderer, merged_points_.data(),
+                                 static_cast<int>(merged_points_.size()));
+            stats.vertices += merged_points_.size();
+            stats.draw_calls++;
+            break;
+        }
+        case PRIMITIVE_RECTS: {
+            merged_rects_.clear();
+            for (size_t k = i; k < j; k++) {
+                const Command &c = commands_[k];
+                merged_rects_.insert(merged_rects_.end(),
+                                     rects_.begin() + c.first,
+                                     rects_.begin() + c.first + c.count);
+            }
+            SDL_RenderFillRects(renderer, merged_rects_.data(),
+                                static_cast<int>(merged_rects_.size()));
+            stats.vertices += merged_rects_.size();
+            stats.draw_calls++;
+            break;
+        }
+        case PRIMITIVE_COPY:
+            for (size_t k = i; k < j; k++) {
+                const Copy &c = copies_[commands_[k].first];
+                if (!c.slot->texture)
+                    continue;
+                SDL_RenderCopy(renderer, c.slot->texture, nullptr, &c.dst);
+                stats.draw_calls++;
+            }
+            break;
+        case PRIMITIVE_QUADS:
+            stats.draw_calls += flushQuads_(renderer, i, j);
+            for (size_t k = i; k < j; k++)
+                stats.vertices += commands_[k].count;
+            break;
+        }
+
+        i = j;
+    }
+
+    if (rasterizer_active)
+        stats.draw_calls += resolveRasterizer_(renderer, camera_active);
+    if (camera_active)
+        SDL_RenderSetViewport(renderer, &screen_viewport);
+    if (target_active) {
+        resolveTarget_(renderer);
+        stats.draw_calls++;
+    }
+
+    commands_.clear();
+    points_.clear();
+    rects_.clear();
+    copies_.clear();
+    quads_.clear();
+    quad_slots_.clear();
+    tasks_.clear();
+    clear_ = false;
+    has_target_ = false;
+    target_.texture.reset();
+    camera_x_ = 0;
+    camera_y_ = 0;
+#if HAS_RENDER_GEOMETRY
+    vertices_.clear();
+    indices_.clear();
+#endif
+    stats_ = stats;
+
+#if DEBUG_RENDER_BATCHING
+    window.commands += stats.commands;
+    window.draw_calls += stats.draw_calls;
+    window.state_changes += stats.state_changes;
+    window.vertices += stats.vertices;
+    if (++frames % RENDER_BATCHING_REPORT_INTERVAL == 0) {
+        LOG("Render batching: %.1f commands, %.1f draw calls, %.1f colour "
+            "changes, %.1f vertices per frame",
+            static_cast<double>(window.commands) /
+                RENDER_BATCHING_REPORT_INTERVAL,
+            static_cast<double>(window.draw_calls) /
+                RENDER_BATCHING_REPORT_INTERVAL,
+            static_cast<double>(window.state_changes) /
+                RENDER_BATCHING_REPORT_INTERVAL,
+            static_cast<double>(window.vertices) /
+                RENDER_BATCHING_REPORT_INTERVAL);
+        window = Stats{0, 0, 0, 0};
+    }
+#endif
+}
+
+int RenderCommandBuffer::flushQuads_(SDL_Renderer *renderer, size_t first,
+                                     size_t last) {
+    SDL_Texture *texture = quad_slots_[commands_[first].first_index]->texture;
+    if (!texture)
+        return 0;
+
+#if HAS_RENDER_GEOMETRY
+    if (hasGeometry()) {
+        int w = 0;
+        int h = 0;
+        SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+        float sx = w > 0 ? 1.0f / static_cast<float>(w) : 0.0f;
+        float sy = h > 0 ? 1.0f / static_cast<float>(h) : 0.0f;
+
+        merged_vertices_.clear();
+        merged_indices_.clear();
+        for (size_t k = first; k < last; k++) {
+            const Command &c = commands_[k];
+            for (uint32_t n = c.first; n < c.first + c.count; n++) {
+                const Quad &q = quads_[n];
+                auto base = static_cast<int>(merged_vertices_.size());
+                float x0 = static_cast<float>(q.dst.x);
+                float y0 = static_cast<float>(q.dst.y);
+                float x1 = static_cast<float>(q.dst.x + q.dst.w);
+                float y1 = static_cast<float>(q.dst.y + q.dst.h);
+                float u0 = static_cast<float>(q.src.x) * sx;
+                float v0 = static_cast<float>(q.src.y) * sy;
+                float u1 = static_cast<float>(q.src.x + q.src.w) * sx;
+                float v1 = static_cast<float>(q.src.y + q.src.h) * sy;
+                merged_vertices_.push_back(SDL_Vertex{
+                    SDL_FPoint{x0, y0}, q.color, SDL_FPoint{u0, v0}});
+                merged_vertices_.push_back(SDL_Vertex{
+                    SDL_FPoint{x1, y0}, q.color, SDL_FPoint{u1, v0}});
+                merged_vertices_.push_back(SDL_Vertex{
+                    SDL_FPoint{x1, y1}, q.color, SDL_FPoint{u1, v1}});
+                merged_vertices_.push_back(SDL_Vertex{
+                    SDL_FPoint{x0, y1}, q.color, SDL_FPoint{u0, v1}});
+                for (int index : {0, 1, 2, 2, 3, 0})
+                    merged_indices_.push_back(base + index);
+            }
+        }
+        if (SDL_RenderGeometry(renderer, texture, merged_vertices_.data(),
+                               static_cast<int>(merged_vertices_.size()),
+                               merged_indices_.data(),
+                               static_cast<int>(merged_indices_.size())) == 0)
+            return 1;
+        LOG("Drawing textured geometry failed, falling back to copies: %s",
+            SDL_GetError());
+        geometry_supported.store(false, std::memory_order_relaxed);
+    }
+#endif
+
+    // One copy per quad, the colour is applied as texture modulation
+    int draw_calls = 0;
+    for (size_t k = first; k < last; k++) {
+        const Command &c = commands_[k];
+        for (uint32_t n = c.first; n < c.first + c.count; n++) {
+            const Quad &q = quads_[n];
+            SDL_SetTextureColorMod(texture, q.color.r, q.color.g, q.color.b);
+            SDL_SetTextureAlphaMod(texture, q.color.a);
+            SDL_RenderCopy(renderer, texture, &q.src, &q.dst);
+            draw_calls++;
+        }
+    }
+    return draw_calls;
+}
+
+void RenderCommandBuffer::writeTrace_() {
+    trace_->beginFrame(clear_, clear_color_, camera_x_, camera_y_,
+                       screen_layer_);
+    for (const Command &c : commands_) {
+        int layer = layerOf(c.key);
+        switch (primitiveOf(c.key)) {
+        case PRIMITIVE_TRIANGLES: {
+#if HAS_RENDER_GEOMETRY
+            merged_points_.clear();
+            for (uint32_t n = c.first; n < c.first + c.count; n++)
+                merged_points_.push_back(
+                    SDL_Point{static_cast<int>(vertices_[n].position.x),
+                              static_cast<int>(vertices_[n].position.y)});
+            trace_->triangles(layer, vertices_[c.first].color,
+                              merged_points_.data(),
+                              static_cast<int>(c.count),
+                              indices_.data() + c.first_index,
+                              static_cast<int>(c.index_count));
+#endif
+            break;
+        }
+        case PRIMITIVE_POINTS:
+            trace_->points(layer, unpackColor(colorOf(c.key)),
+                           points_.data() + c.first,
+                           static_cast<int>(c.count));
+            break;
+        case PRIMITIVE_RECTS:
+            trace_->rects(layer, unpackColor(colorOf(c.key)),
+                          rects_.data() + c.first, static_cast<int>(c.count));
+            break;
+        case PRIMITIVE_COPY: {
+            const Copy &copy = copies_[c.first];
+            int w = 0;
+            int h = 0;
+            if (copy.slot->texture)
+                SDL_QueryTexture(copy.slot->texture, nullptr, nullptr, &w,
+                                 &h);
+            trace_->copy(layer, copy.slot->id, w, h, copy.dst);
+            break;
+        }
+        case PRIMITIVE_QUADS: {
+            const TextureSlot::Ptr &slot = quad_slots_[c.first_index];
+            int w = 0;
+            int h = 0;
+            if (slot->texture)
+                SDL_QueryTexture(slot->texture, nullptr, nullptr, &w, &h);
+            trace_->quads(layer, slot->id, w, h, quads_[c.first].color,
+                          static_cast<int>(c.count));
+            for (uint32_t n = c.first; n < c.first + c.count; n++)
+                trace_->quadRects(quads_[n].src, quads_[n].dst);
+            break;
+        }
+        }
+    }
+    trace_->endFrame();
+}
+
+void RenderCommandBuffer::resolveTarget_(SDL_Renderer *renderer) {
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_RenderCopy(renderer, target_.texture->texture, &target_.src, nullptr);
+}
+
+SDL_Rect RenderCommandBuffer::applyCamera_(SDL_Renderer *renderer) const {
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(renderer, &viewport);
+
+    // Growing the viewport by the offset keeps its far edges in place, so
+    // nothing on screen is clipped
+    SDL_Rect camera{viewport.x + camera_x_, viewport.y + camera_y_,
+                    viewport.w - camera_x_, viewport.h - camera_y_};
+    SDL_RenderSetViewport(renderer, &camera);
+    return viewport;
+}
+
+void RenderCommandBuffer::rasterize_(size_t first, size_t last) {
+    // The rasterizer draws in screen coordinates, it applies the camera
+    // itself
+    int layer = layerOf(commands_[first].key);
+    int offset_x = layer < screen_layer_ ? camera_x_ : 0;
+    int offset_y = layer < screen_layer_ ? camera_y_ : 0;
+    uint32_t color = colorOf(commands_[first].key);
+
+    for (size_t k = first; k < last; k++) {
+        const Command &c = commands_[k];
+        switch (primitiveOf(c.key)) {
+        case PRIMITIVE_TRIANGLES:
+#if HAS_RENDER_GEOMETRY
+            rasterizer_->triangles(&vertices_[c.first],
+                                   &indices_[c.first_index], c.index_count,
+                                   offset_x, offset_y);
+#endif
+            break;
+        case PRIMITIVE_POINTS:
+            rasterizer_->points(color, &points_[c.first], c.count, offset_x,
+                                offset_y);
+            break;
+        case PRIMITIVE_RECTS:
+            rasterizer_->rects(color, &rects_[c.first], c.count, offset_x,
+                               offset_y);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int RenderCommandBuffer::resolveRasterizer_(SDL_Renderer *renderer,
+                                            bool camera_active) {
+    // Undo the camera viewport, the framebuffer covers the screen
+    return camera_active
+               ? rasterizer_->resolve(renderer, -camera_x_, -camera_y_)
+               : rasterizer_->resolve(renderer, 0, 0);
+}
+
+void RenderCommandBuffer::setTrace(RenderTrace *trace) { trace_ = trace; }
+
+void RenderCommandBuffer::setRasterizer(SoftwareRasterizer *rasterizer) {
+    rasterizer_ = rasterizer;
+}
+
+const RenderCommandBuffer::Stats &RenderCommandBuffer::getStats() const {
+    return stats_;
+}
@@ -0,0 +1,356 @@
+#ifndef RENDERCOMMANDBUFFER_H
+#define RENDERCOMMANDBUFFER_H
+
+#include "../blaster.h"
+#include "SDL2/SDL.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/// SDL_RenderGeometry is available from SDL 2.0.18 on
+#define HAS_RENDER_GEOMETRY SDL_VERSION_ATLEAST(2, 0, 18)
+
+///
+/// \brief Primitive types recorded by the command buffer, in the order they
+/// are drawn within a render layer
+///
+enum RenderPrimitive {
+    PRIMITIVE_TRIANGLES,
+    PRIMITIVE_RECTS,
+    PRIMITIVE_POINTS,
+    PRIMITIVE_COPY,
+    PRIMITIVE_QUADS
+};
+
+///
+/// \brief Texture owned by the thread flushing the command buffers
+///
+/// Textures may only be created, drawn and destroyed by the thread owning
+/// the renderer. Render objects hold a slot, fill and empty it with deferred
+/// render tasks and reference it in copy commands. Textures left in a slot
+/// are freed together with the renderer.
+///
+struct TextureSlot {
+    typedef std::shared_ptr<TextureSlot> Ptr;
+
+    TextureSlot();
+
+    SDL_Texture *texture = nullptr; // renderer thread only
+    const uint32_t id;              // unique id, quads are batched by it
+};
+
+///
+/// \brief Work run with the renderer before the draw commands of a frame
+///
+typedef std::function<void(SDL_Renderer *renderer)> RenderTask;
+
+class RenderTrace;
+class SoftwareRasterizer;
+
+///
+/// \brief Intermediate render target the lower layers of a frame are drawn
+/// into before being stretched over the screen
+///
+struct ScaledTarget {
+    TextureSlot::Ptr texture; // target texture, skipped while empty
+    float scale_x;            // render scale within the target
+    float scale_y;
+    SDL_Rect src;             // part of the target covering the screen
+    int native_layer;         // first layer drawn directly to the screen
+};
+
+///
+/// \brief The RenderCommandBuffer class collects the draw commands of a frame
+/// and submits them to SDL in as few calls as possible.
+///
+/// Render objects record commands instead of drawing directly. On flush()
+/// the commands are sorted by (layer, primitive, colour) and the vertices of
+/// all commands sharing a key are merged, so every colour of a layer costs a
+/// single colour change and a single draw call. Commands with the same key
+/// keep their submission order.
+///
+/// Line strips are rasterized into horizontal or vertical runs on record and
+/// drawn as filled rectangles. This is how SDL itself draws lines on a scaled
+/// renderer, and unlike line strips the rectangles of many commands can be
+/// merged into one SDL_RenderFillRects call.
+///
+/// Triangles carry their colour per vertex, so all triangles of a layer are
+/// drawn with a single SDL_RenderGeometry call. Triangles are only available
+/// with HAS_RENDER_GEOMETRY and if the renderer supports them, see
+/// hasGeometry().
+///
+/// Texture copies are not merged but are ordered with the other commands of
+/// their layer. Textured quads of the same texture are merged into a single
+/// SDL_RenderGeometry call, or drawn one SDL_RenderCopy at a time without
+/// geometry support.
+///
+/// With a SoftwareRasterizer attached, points, rectangles and triangles are
+/// drawn on the CPU and handed to the renderer as one texture copy before
+/// the next textured group, target switch or the end of the frame.
+///
+/// A recorded buffer is a self-contained snapshot of the frame. It can be
+/// flushed by another thread than the one that recorded it, as long as the
+/// two do not use the buffer at the same time.
+///
+class RenderCommandBuffer {
+  public:
+    ///
+    /// \brief Submission statistics of a flushed frame
+    ///
+    struct Stats {
+        int commands;      // commands recorded
+        int draw_calls;    // SDL draw calls issued
+        int state_changes; // SDL draw colour changes
+        size_t vertices;   // points and rectangles submitted
+    };
+
+    ///
+    /// \brief Records points
+    /// \param layer render layer
+    /// \param color draw colour
+    /// \param points points to draw, copied
+    /// \param n number of points
+    /// \param offset_x x offset added to every point
+    /// \param offset_y y offset added to every point
+    ///
+    void drawPoints(int layer, SDL_Color color, const SDL_Point *points, int n,
+                    int offset_x = 0, int offset_y = 0);
+
+    ///
+    /// \brief Records a line strip connecting consecutive points
+    /// \param layer render layer
+    /// \param color draw colour
+    /// \param points strip points, copied
+    /// \param n number of points
+    /// \param offset_x x offset added to every point
+    /// \param offset_y y offset added to every point
+    ///
+    void drawLines(int layer, SDL_Color color, const SDL_Point *points, int n,
+                   int offset_x = 0, int offset_y = 0);
+
+    ///
+    /// \brief Records filled rectangles
+    /// \param layer render layer
+    /// \param color draw colour
+    /// \param rects rectangles to fill, copied
+    /// \param n number of rectangles
+    /// \param offset_x x offset added to every rectangle
+    /// \param offset_y y offset added to every rectangle
+    ///
+    void fillRects(int layer, SDL_Color color, const SDL_Rect *rects, int n,
+                   int offset_x = 0, int offset_y = 0);
+
+#if HAS_RENDER_GEOMETRY
+    ///
+    /// \brief Records indexed triangles
+    /// \param layer render layer
+    /// \param color fill colour
+    /// \param vertices triangle vertices, copied
+    /// \param n_vertices number of vertices
+    /// \param indices three vertex indices per triangle, copied
+    /// \param n_indices number of indices
+    /// \param offset_x x offset added to every vertex
+    /// \param offset_y y offset added to every vertex
+    ///
+    void drawTriangles(int layer, SDL_Color color, const SDL_Point *vertices,
+                       int n_vertices, const int *indices, int n_indices,
+                       int offset_x = 0, int offset_y = 0);
+#endif
+
+    ///
+    /// \brief Checks if triangles can be drawn. False without
+    /// HAS_RENDER_GEOMETRY or after the renderer rejected geometry.
+    ///
+    [[nodiscard]] bool hasGeometry() const;
+
+    ///
+    /// \brief Records a texture copy, skipped if the slot is empty when the
+    /// buffer is flushed
+    /// \param layer render layer
+    /// \param slot source texture slot
+    /// \param dst destination rectangle
+    ///
+    void copy(int layer, const TextureSlot::Ptr &slot, const SDL_Rect &dst);
+
+    ///
+    /// \brief Records textured quads, skipped if the slot is empty when the
+    /// buffer is flushed
+    /// \param layer render layer
+    /// \param slot source texture slot
+    /// \param color colour the texture is modulated with
+    /// \param src source rectangles in the texture
+    /// \param dst destination rectangles
+    /// \param n number of quads
+    /// \param offset_x x offset added to every destination
+    /// \param offset_y y offset added to every destination
+    ///
+    void drawQuads(int layer, const TextureSlot::Ptr &slot, SDL_Color color,
+                   const SDL_Rect *src, const SDL_Rect *dst, int n,
+                   int offset_x = 0, int offset_y = 0);
+
+    ///
+    /// \brief Sets the colour the frame is cleared with before drawing
+    /// \param color clear colour
+    ///
+    void setClearColor(SDL_Color color);
+
+    ///
+    /// \brief Draws the layers below target.native_layer of this frame into
+    /// a target texture, including the clear, and stretches the target over
+    /// the screen before drawing the remaining layers
+    /// \param target render target
+    ///
+    void setScaledTarget(const ScaledTarget &target);
+
+    ///
+    /// \brief Sets the camera of the frame. Layers below screen_layer are
+    /// recorded in world coordinates and shifted by the camera offset on the
+    /// renderer with SDL_RenderSetViewport, the other layers are recorded in
+    /// screen coordinates.
+    /// \param offset_x camera offset added to world x coordinates
+    /// \param offset_y camera offset added to world y coordinates
+    /// \param screen_layer first layer in screen coordinates
+    ///
+    void setCamera(int offset_x, int offset_y, int screen_layer);
+
+    ///
+    /// \brief Records work that needs the renderer, such as creating
+    /// textures. Tasks run in recording order before the draw commands.
+    /// \param task task to run
+    ///
+    void defer(RenderTask task);
+
+    ///
+    /// \brief Runs and clears the deferred tasks without drawing anything
+    /// \param renderer renderer passed to the tasks
+    ///
+    void runTasks(SDL_Renderer *renderer);
+
+    ///
+    /// \brief Sorts, merges and submits the recorded commands and clears the
+    /// buffer. Buffer capacity is kept for the next frame.
+    /// \param renderer renderer to draw with
+    ///
+    void flush(SDL_Renderer *renderer);
+
+    ///
+    /// \brief Attaches a trace the flushed commands are written to while it
+    /// is capturing
+    /// \param trace trace, nullptr detaches
+    ///
+    void setTrace(RenderTrace *trace);
+
+    ///
+    /// \brief Attaches a rasterizer drawing the untextured primitives
+    /// \param rasterizer rasterizer, nullptr draws them with the renderer
+    ///
+    void setRasterizer(SoftwareRasterizer *rasterizer);
+
+    ///
+    /// \brief Gets the statistics of the last flush
+    /// \return statistics
+    ///
+    [[nodiscard]] const Stats &getStats() const;
+
+  private:
+    struct Command {
+        uint64_t key;   // layer, primitive, colour and submission order
+        uint32_t first; // first element in the primitive array
+        uint32_t count; // number of elements
+        uint32_t first_index; // first triangle index, texture slot of quads
+        uint32_t index_count; // number of triangle indices
+    };
+
+    struct Copy {
+        TextureSlot::Ptr slot;
+        SDL_Rect dst;
+    };
+
+    struct Quad {
+        SDL_Rect src;
+        SDL_Rect dst;
+        SDL_Color color;
+    };
+
+    ///
+    /// \brief Builds a sort key, commands with equal key bits above the
+    /// sequence number are merged
+    /// \param state packed draw colour, or texture id for quads
+    ///
+    uint64_t key_(int layer, RenderPrimitive primitive, uint32_t state);
+
+    ///
+    /// \brief Appends the runs of a single line segment to rects_
+    ///
+    void rasterizeLine_(int x0, int y0, int x1, int y1);
+
+    ///
+    /// \brief Draws the quads of commands [first, last), which share a
+    /// texture
+    /// \return number of draw calls issued
+    ///
+    int flushQuads_(SDL_Renderer *renderer, size_t first, size_t last);
+
+    ///
+    /// \brief Writes the recorded commands to the trace
+    ///
+    void writeTrace_();
+
+    ///
+    /// \brief Switches back from the scaled target to the screen and draws
+    /// the target onto it
+    ///
+    void resolveTarget_(SDL_Renderer *renderer);
+
+    ///
+    /// \brief Moves the viewport origin by the camera offset
+    /// \return viewport to restore
+    ///
+    SDL_Rect applyCamera_(SDL_Renderer *renderer) const;
+
+    ///
+    /// \brief Draws the untextured commands [first, last) with the
+    /// rasterizer
+    ///
+    void rasterize_(size_t first, size_t last);
+
+    ///
+    /// \brief Draws what the rasterizer holds
+    /// \param camera_active if the camera viewport is applied
+    /// \return number of draw calls issued
+    ///
+    int resolveRasterizer_(SDL_Renderer *renderer, bool camera_active);
+
+    std::vector<Command> commands_;
+    std::vector<SDL_Point> points_;
+    std::vector<SDL_Rect> rects_;
+    std::vector<Copy> copies_;
+    std::vector<Quad> quads_;
+    std::vector<TextureSlot::Ptr> quad_slots_;
+    std::vector<RenderTask> tasks_;
+    SDL_Color clear_color_ = SDL_Color{0, 0, 0, 0};
+    bool clear_ = false;
+    RenderTrace *trace_ = nullptr;
+    SoftwareRasterizer *rasterizer_ = nullptr;
+    ScaledTarget target_;
+    bool has_target_ = false;
+    int camera_x_ = 0;
+    int camera_y_ = 0;
+    int screen_layer_ = N_RENDER_LAYERS;
+
+    // Merged arrays handed to SDL
+    std::vector<SDL_Point> merged_points_;
+    std::vector<SDL_Rect> merged_rects_;
+
+#if HAS_RENDER_GEOMETRY
+    std::vector<SDL_Vertex> vertices_;
+    std::vector<int> indices_;
+    std::vector<SDL_Vertex> merged_vertices_;
+    std::vector<int> merged_indices_;
+#endif
+
+    Stats stats_ = Stats{0, 0, 0, 0};
+};
+
+#endif // RENDERCOMMANDBUFFER_H
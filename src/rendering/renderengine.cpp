@@ -1,6 +1,14 @@
 #include "renderengine.h"
+#include "../memory/alloctracker.h"
+#include "polygonlod.h"
 
-RenderEngine::RenderEngine(Viewport *vp) { vp_ = vp; }
+RenderEngine::RenderEngine(Viewport *vp) {
+    vp_ = vp;
+    for (auto &buffer : buffers_)
+        buffer.setTrace(&trace_);
+}
+
+RenderEngine::~RenderEngine() { stopThread(); }
 
 void RenderEngine::addObject(RenderObject *obj) {
     if (obj->getRenderLayer() > TOP_RENDER_LAYER_IDX ||
@@ -22,12 +30,139 @@ void RenderEngine::removeObject(RenderObject *obj) {
 }
 
 void RenderEngine::render() {
+    ALLOC_SCOPE(ALLOC_RENDERING);
+    culled_ = 0;
+    rendered_ = 0;
+
+    // Applied once per frame on the renderer instead of to every vertex
+    getCommandBuffer().setCamera(vp_->getOffsetX(), vp_->getOffsetY(),
+                                 HUD_RENDER_LAYER_IDX);
+
     for (int i = 0; i < N_RENDER_LAYERS; i++) {
         for (auto obj : objects_[i]) {
-            if (obj->isRendering()) {
-                obj->render(vp_->getOffsetX(),
-                            vp_->getOffsetY());
+            if (!obj->isRendering())
+                continue;
+
+            if (!obj->isInView()) {
+                culled_++;
+                continue;
             }
+
+            obj->render(vp_->getOffsetX(),
+                        vp_->getOffsetY());
+            rendered_++;
         }
     }
+    g_polygon_lod.endFrame();
+
+#if DEBUG_VIEW_CULLING
+    culled_total_ += culled_;
+    rendered_total_ += rendered_;
+    if (++frames_ % VIEW_CULLING_REPORT_INTERVAL == 0) {
+        LOG("View culling: %.1f objects rendered, %.1f culled per frame",
+            static_cast<double>(rendered_total_) /
+                VIEW_CULLING_REPORT_INTERVAL,
+            static_cast<double>(culled_total_) / VIEW_CULLING_REPORT_INTERVAL);
+        culled_total_ = 0;
+        rendered_total_ = 0;
+    }
+#endif
 }
+
+void RenderEngine::present(SDL_Renderer *renderer) {
+    if (!thread_.joinable()) {
+        buffers_[recording_].flush(renderer);
+        Uint64 present_start = SDL_GetPerformanceCounter();
+        SDL_RenderPresent(renderer);
+        present_ticks_ = SDL_GetPerformanceCounter() - present_start;
+        return;
+    }
+
+    Uint64 wait_start = SDL_GetPerformanceCounter();
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // The render thread picks up every frame, at most one frame is queued
+    cv_.wait(lock, [this] { return published_ < 0; });
+    published_ = recording_;
+    cv_.notify_all();
+
+    // Continue in the other buffer once the render thread is done with it
+    int next = recording_ ^ 1;
+    cv_.wait(lock, [this, next] { return drawing_ != next; });
+    recording_ = next;
+    present_ticks_ = SDL_GetPerformanceCounter() - wait_start;
+}
+
+void RenderEngine::startThread(SDL_Renderer *renderer) {
+    if (thread_.joinable())
+        return;
+
+    renderer_ = renderer;
+    quit_ = false;
+    thread_ = std::thread(&RenderEngine::threadMain_, this);
+    LOG("Render thread started");
+}
+
+void RenderEngine::stopThread() {
+    if (!thread_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    published_ = -1;
+    drawing_ = -1;
+}
+
+void RenderEngine::runPendingTasks(SDL_Renderer *renderer) {
+    getCommandBuffer().runTasks(renderer);
+}
+
+void RenderEngine::threadMain_() {
+    ALLOC_SCOPE(ALLOC_RENDERING);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return quit_ || published_ >= 0; });
+        if (published_ < 0)
+            break;
+
+        int frame = published_;
+        drawing_ = frame;
+        published_ = -1;
+        cv_.notify_all();
+
+        lock.unlock();
+        buffers_[frame].flush(renderer_);
+        SDL_RenderPresent(renderer_);
+        lock.lock();
+
+        drawing_ = -1;
+        cv_.notify_all();
+    }
+}
+
+void RenderEngine::startTrace(const std::string &path, int frames) {
+    // The trace belongs to the flushing thread, start it from there
+    getCommandBuffer().defer([this, path, frames](SDL_Renderer *) {
+        trace_.open(path, frames);
+    });
+}
+
+void RenderEngine::enableRasterizer() {
+    if (rasterizer_)
+        return;
+    rasterizer_.reset(new SoftwareRasterizer(SCREEN_RES_W, SCREEN_RES_H));
+    for (auto &buffer : buffers_)
+        buffer.setRasterizer(rasterizer_.get());
+}
+
+RenderCommandBuffer &RenderEngine::getCommandBuffer() {
+    return buffers_[recording_];
+}
+
+int RenderEngine::getCulledObjects() const { return culled_; }
+int RenderEngine::getRenderedObjects() const { return rendered_; }
+Uint64 RenderEngine::getPresentTicks() const { return present_ticks_; }
@@ -2,9 +2,28 @@
 #define RENDERENGINE_H
 
 #include "../game/viewport.h"
+#include "rendercommandbuffer.h"
 #include "renderobject.h"
+#include "rendertrace.h"
+#include "softwarerasterizer.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <string>
+#include <thread>
 
+///
+/// \brief The RenderEngine class records the render objects of each frame
+/// into a command buffer and presents it.
+///
+/// Frames are recorded into one of two command buffers. Without a render
+/// thread present() draws the recorded buffer right away. With a render
+/// thread present() hands the buffer over as the newest frame snapshot and
+/// recording continues into the other buffer, so simulating the next frame
+/// overlaps with drawing and presenting this one. The game thread waits only
+/// if the render thread is still drawing the buffer it wants to record into.
+///
 class RenderEngine {
   public:
     ///
@@ -12,6 +31,7 @@ class RenderEngine {
     /// RenderObject instances on each frame
     ///
     RenderEngine(Viewport *vp);
+    ~RenderEngine();
 
     ///
     /// \brief addObject adds an object to the render queue
@@ -26,13 +46,101 @@ class RenderEngine {
     void removeObject(RenderObject *obj);
 
     ///
-    /// \brief render runs render tasks on each render queue object
+    /// \brief render runs render tasks on each render queue object, the
+    /// objects record their draws to the current command buffer
     ///
     void render();
 
+    ///
+    /// \brief Draws and presents the recorded frame, or hands it over to
+    /// the render thread if one is running
+    /// \param renderer renderer to draw with, ignored with a render thread
+    ///
+    void present(SDL_Renderer *renderer);
+
+    ///
+    /// \brief Starts a render thread that owns the renderer from now on.
+    /// After this no other thread may use the renderer until stopThread().
+    /// \param renderer renderer to draw with
+    ///
+    void startThread(SDL_Renderer *renderer);
+
+    ///
+    /// \brief Stops the render thread once it has presented the frames handed
+    /// over to it, the renderer is usable again by the calling thread
+    ///
+    void stopThread();
+
+    ///
+    /// \brief Runs the tasks deferred since the last presented frame, such as
+    /// saving it. Called at shutdown after stopThread(), when no further
+    /// frame is going to flush them.
+    /// \param renderer renderer passed to the tasks
+    ///
+    void runPendingTasks(SDL_Renderer *renderer);
+
+    ///
+    /// \brief Captures the draw commands of the next frames to a trace file,
+    /// see tools/replay. The capture starts with the frame currently being
+    /// recorded.
+    /// \param path trace file path
+    /// \param frames number of frames to capture
+    ///
+    void startTrace(const std::string &path, int frames);
+
+    ///
+    /// \brief Draws the points, lines and fills of all frames on the CPU
+    /// from now on, see SoftwareRasterizer. Must be called before
+    /// startThread().
+    ///
+    void enableRasterizer();
+
+    ///
+    /// \brief Gets the command buffer render objects record their draws to
+    /// \return command buffer of the current frame
+    ///
+    RenderCommandBuffer &getCommandBuffer();
+
+    /// Number of objects skipped by the last render for being out of view
+    [[nodiscard]] int getCulledObjects() const;
+
+    /// Number of objects rendered by the last render
+    [[nodiscard]] int getRenderedObjects() const;
+
+    /// Performance counter ticks the last present() spent blocked on
+    /// SDL_RenderPresent or on the render thread
+    [[nodiscard]] Uint64 getPresentTicks() const;
+
   private:
+    ///
+    /// \brief Render thread loop, draws and presents published buffers
+    ///
+    void threadMain_();
+
     std::set<RenderObject *> objects_[N_RENDER_LAYERS];
+    RenderCommandBuffer buffers_[2];
+    int recording_ = 0; // buffer being recorded by the game thread
+    RenderTrace trace_;  // used by the thread flushing the buffers
+    std::unique_ptr<SoftwareRasterizer> rasterizer_; // flushing thread
     Viewport *vp_;
+
+    // Render thread state, guarded by mutex_
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    SDL_Renderer *renderer_ = nullptr;
+    int published_ = -1; // buffer waiting for the render thread
+    int drawing_ = -1;   // buffer being drawn by the render thread
+    bool quit_ = false;
+
+    int culled_ = 0;
+    int rendered_ = 0;
+    Uint64 present_ticks_ = 0;
+#if DEBUG_VIEW_CULLING
+    long long culled_total_ = 0;
+    long long rendered_total_ = 0;
+    unsigned int frames_ = 0;
+#endif
 };
 
 #endif // RENDERENGINE_H
@@ -24,13 +24,17 @@ class RenderObject {
     ///
     RenderObject(RenderEngine *renderEngine, int layer);
 
-    void init(RenderEngine* renderEngine, int layer=TOP_RENDER_LAYER_IDX - 1);
+    void init(RenderEngine* renderEngine,
+              int layer=WORLD_TOP_RENDER_LAYER_IDX - 1);
 
     virtual ~RenderObject();
 
     ///
     /// \brief render function to be called on every frame by
-    /// RenderEngine if rendering_ is set to true
+    /// RenderEngine if rendering_ is set to true. World layers are recorded
+    /// in world coordinates, the camera is applied by the renderer.
+    /// \param offset_x camera offset x, for visibility decisions
+    /// \param offset_y camera offset y, for visibility decisions
     ///
     virtual void render(int offset_x, int offset_y) = 0;
 
@@ -74,7 +78,7 @@ class RenderObject {
     void setRenderLayer(int layer);
 
   protected:
-    int layer_ = TOP_RENDER_LAYER_IDX - 1;
+    int layer_ = WORLD_TOP_RENDER_LAYER_IDX - 1;
     bool rendering_ = true;
     bool in_view_ = true;
     bool static_ = false;
@@ -0,0 +1,313 @@
+#include "rendertrace.h"
+#include "../blaster.h"
+#include <cstring>
+
+namespace {
+
+const char TRACE_MAGIC[4] = {'S', 'B', 'R', 'T'};
+const uint32_t TRACE_VERSION = 2;
+
+} // namespace
+
+RenderTrace::~RenderTrace() { close_(); }
+
+bool RenderTrace::open(const std::string &path, int frames) {
+    close_();
+    file_ = fopen(path.c_str(), "wb");
+    if (!file_) {
+        LOG("Could not open render trace %s", path.c_str());
+        return false;
+    }
+
+    path_ = path;
+    frames_left_ = frames;
+    frames_ = 0;
+    write_(TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    writeU32_(TRACE_VERSION);
+    LOG("Capturing %d frames to render trace %s", frames, path.c_str());
+    return true;
+}
+
+bool RenderTrace::isCapturing() const { return file_ != nullptr; }
+
+void RenderTrace::close_() {
+    if (!file_)
+        return;
+
+    fclose(file_);
+    file_ = nullptr;
+    LOG("Captured %d frames to render trace %s", frames_, path_.c_str());
+}
+
+void RenderTrace::write_(const void *data, size_t size) {
+    fwrite(data, 1, size, file_);
+}
+
+void RenderTrace::writeU8_(uint8_t value) { write_(&value, sizeof(value)); }
+
+void RenderTrace::writeU32_(uint32_t value) { write_(&value, sizeof(value)); }
+
+void RenderTrace::writeColor_(SDL_Color color) {
+    uint8_t rgba[4] = {color.r, color.g, color.b, color.a};
+    write_(rgba, sizeof(rgba));
+}
+
+void RenderTrace::writeRect_(const SDL_Rect &rect) {
+    int32_t values[4] = {rect.x, rect.y, rect.w, rect.h};
+    write_(values, sizeof(values));
+}
+
+void RenderTrace::beginFrame(bool clear, SDL_Color clear_color,
+                             int camera_x, int camera_y, int screen_layer) {
+    writeU8_(TRACE_FRAME);
+    writeU8_(clear ? 1 : 0);
+    writeColor_(clear_color);
+    int32_t camera[2] = {camera_x, camera_y};
+    write_(camera, sizeof(camera));
+    writeU8_(static_cast<uint8_t>(screen_layer));
+}
+
+void RenderTrace::points(int layer, SDL_Color color, const SDL_Point *points,
+                         int n) {
+    writeU8_(TRACE_POINTS);
+    writeU8_(static_cast<uint8_t>(layer));
+    writeColor_(color);
+    writeU32_(static_cast<uint32_t>(n));
+    for (int i = 0; i < n; i++) {
+        int32_t values[2] = {points[i].x, points[i].y};
+        write_(values, sizeof(values));
+    }
+}
+
+void RenderTrace::rects(int layer, SDL_Color color, const SDL_Rect *rects,
+                        int n) {
+    writeU8_(TRACE_RECTS);
+    writeU8_(static_cast<uint8_t>(layer));
+    writeColor_(color);
+    writeU32_(static_cast<uint32_t>(n));
+    for (int i = 0; i < n; i++)
+        writeRect_(rects[i]);
+}
+
+void RenderTrace::triangles(int layer, SDL_Color color,
+                            const SDL_Point *vertices, int n_vertices,
+                            const int *indices, int n_indices) {
+    writeU8_(TRACE_TRIANGLES);
+    writeU8_(static_cast<uint8_t>(layer));
+    writeColor_(color);
+    writeU32_(static_cast<uint32_t>(n_vertices));
+    for (int i = 0; i < n_vertices; i++) {
+        int32_t values[2] = {vertices[i].x, vertices[i].y};
+        write_(values, sizeof(values));
+    }
+    writeU32_(static_cast<uint32_t>(n_indices));
+    for (int i = 0; i < n_indices; i++) {
+        int32_t value = indices[i];
+        write_(&value, sizeof(value));
+    }
+}
+
+void RenderTrace::copy(int layer, uint32_t texture, int texture_w,
+                       int texture_h, const SDL_Rect &dst) {
+    writeU8_(TRACE_COPY);
+    writeU8_(static_cast<uint8_t>(layer));
+    writeU32_(texture);
+    int32_t size[2] = {texture_w, texture_h};
+    write_(size, sizeof(size));
+    writeRect_(dst);
+}
+
+void RenderTrace::quads(int layer, uint32_t texture, int texture_w,
+                        int texture_h, SDL_Color color, int n) {
+    writeU8_(TRACE_QUADS);
+    writeU8_(static_cast<uint8_t>(layer));
+    writeU32_(texture);
+    int32_t size[2] = {texture_w, texture_h};
+    write_(size, sizeof(size));
+    writeColor_(color);
+    writeU32_(static_cast<uint32_t>(n));
+}
+
+void RenderTrace::quadRects(const SDL_Rect &src, const SDL_Rect &dst) {
+    writeRect_(src);
+    writeRect_(dst);
+}
+
+void RenderTrace::endFrame() {
+    writeU8_(TRACE_END_FRAME);
+    frames_++;
+    if (--frames_left_ <= 0)
+        close_();
+}
+
+bool RenderTraceReader::load(const std::string &path) {
+    data_.clear();
+    frames_.clear();
+    textures_.clear();
+
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file) {
+        LOG("Could not open render trace %s", path.c_str());
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data_.insert(data_.end(), chunk, chunk + n);
+    fclose(file);
+
+    size_t pos = 0;
+    char magic[4];
+    uint32_t version = 0;
+    if (!read_(pos, magic, sizeof(magic)) ||
+        memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0 ||
+        !read_(pos, &version, sizeof(version)) || version != TRACE_VERSION) {
+        LOG("%s is not a version %u render trace", path.c_str(),
+            TRACE_VERSION);
+        return false;
+    }
+
+    // Index the frames, a trailing incomplete frame is dropped
+    uint8_t type;
+    while (read_(pos, &type, sizeof(type))) {
+        size_t start = pos - 1;
+        if (type != TRACE_FRAME || !decode_(pos, nullptr)) {
+            LOG("Render trace %s is malformed after %zu frames", path.c_str(),
+                frames_.size());
+            break;
+        }
+        frames_.push_back(start);
+    }
+    return !frames_.empty();
+}
+
+size_t RenderTraceReader::getFrames() const { return frames_.size(); }
+
+std::map<uint32_t, RenderTraceReader::Texture> &
+RenderTraceReader::getTextures() {
+    return textures_;
+}
+
+void RenderTraceReader::record(size_t frame, RenderCommandBuffer &buffer) {
+    // Skip the type byte, frames were validated on load
+    size_t pos = frames_[frame] + 1;
+    decode_(pos, &buffer);
+}
+
+bool RenderTraceReader::read_(size_t &pos, void *out, size_t size) const {
+    if (pos + size > data_.size())
+        return false;
+    memcpy(out, data_.data() + pos, size);
+    pos += size;
+    return true;
+}
+
+bool RenderTraceReader::decode_(size_t &pos, RenderCommandBuffer *buffer) {
+    uint8_t clear;
+    SDL_Color color;
+    int32_t camera[2];
+    uint8_t screen_layer;
+    if (!read_(pos, &clear, sizeof(clear)) ||
+        !read_(pos, &color, sizeof(color)) ||
+        !read_(pos, camera, sizeof(camera)) ||
+        !read_(pos, &screen_layer, sizeof(screen_layer)))
+        return false;
+    if (buffer && clear)
+        buffer->setClearColor(color);
+    if (buffer)
+        buffer->setCamera(camera[0], camera[1], screen_layer);
+
+    while (true) {
+        uint8_t type;
+        uint8_t layer;
+        uint32_t n;
+        if (!read_(pos, &type, sizeof(type)))
+            return false;
+
+        switch (type) {
+        case TRACE_END_FRAME:
+            return true;
+        case TRACE_POINTS:
+        case TRACE_RECTS:
+        case TRACE_TRIANGLES:
+            if (!read_(pos, &layer, sizeof(layer)) ||
+                !read_(pos, &color, sizeof(color)) ||
+                !read_(pos, &n, sizeof(n)) || n > data_.size())
+                return false;
+            if (type == TRACE_RECTS) {
+                rects_.resize(n);
+                if (!read_(pos, rects_.data(), n * sizeof(SDL_Rect)))
+                    return false;
+                if (buffer)
+                    buffer->fillRects(layer, color, rects_.data(),
+                                      static_cast<int>(n));
+                break;
+            }
+
+            points_.resize(n);
+            if (!read_(pos, points_.data(), n * sizeof(SDL_Point)))
+                return false;
+            if (type == TRACE_POINTS) {
+                if (buffer)
+                    buffer->drawPoints(layer, color, points_.data(),
+                                       static_cast<int>(n));
+                break;
+            }
+
+            uint32_t n_indices;
+            if (!read_(pos, &n_indices, sizeof(n_indices)) ||
+                n_indices > data_.size())
+                return false;
+            indices_.resize(n_indices);
+            if (!read_(pos, indices_.data(), n_indices * sizeof(int)))
+                return false;
+#if HAS_RENDER_GEOMETRY
+            if (buffer)
+                buffer->drawTriangles(layer, color, points_.data(),
+                                      static_cast<int>(n), indices_.data(),
+                                      static_cast<int>(n_indices));
+#endif
+            break;
+        case TRACE_COPY:
+        case TRACE_QUADS: {
+            uint32_t id;
+            int32_t size[2];
+            if (!read_(pos, &layer, sizeof(layer)) ||
+                !read_(pos, &id, sizeof(id)) ||
+                !read_(pos, size, sizeof(size)))
+                return false;
+
+            Texture &texture = textures_[id];
+            if (!texture.slot)
+                texture = Texture{TextureSlot::Ptr(new TextureSlot), size[0],
+                                  size[1]};
+
+            if (type == TRACE_COPY) {
+                SDL_Rect dst;
+                if (!read_(pos, &dst, sizeof(dst)))
+                    return false;
+                if (buffer)
+                    buffer->copy(layer, texture.slot, dst);
+                break;
+            }
+
+            if (!read_(pos, &color, sizeof(color)) ||
+                !read_(pos, &n, sizeof(n)) || n > data_.size())
+                return false;
+            src_.resize(n);
+            rects_.resize(n);
+            for (uint32_t i = 0; i < n; i++) {
+                if (!read_(pos, &src_[i], sizeof(SDL_Rect)) ||
+                    !read_(pos, &rects_[i], sizeof(SDL_Rect)))
+                    return false;
+            }
+            if (buffer)
+                buffer->drawQuads(layer, texture.slot, color, src_.data(),
+                                  rects_.data(), static_cast<int>(n));
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#ifndef RENDERTRACE_H
+#define RENDERTRACE_H
+
+#include "SDL2/SDL.h"
+#include "rendercommandbuffer.h"
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+///
+/// \brief Record types of a render trace file
+///
+/// A trace starts with the magic "SBRT" and a 32-bit version, followed by
+/// records. Every record starts with its type byte. Values are written in
+/// host byte order, coordinates as 32-bit integers.
+///
+enum RenderTraceRecord : uint8_t {
+    TRACE_FRAME,     // clear flag (u8), clear colour (4 x u8), camera
+                     // offset x and y, screen layer (u8)
+    TRACE_POINTS,    // layer (u8), colour, n (u32), n points
+    TRACE_RECTS,     // layer (u8), colour, n (u32), n rectangles
+    TRACE_TRIANGLES, // layer (u8), colour, n (u32), n points, m (u32),
+                     // m indices
+    TRACE_COPY,      // layer (u8), texture id (u32), texture w and h, dst
+    TRACE_QUADS,     // layer (u8), texture id (u32), texture w and h,
+                     // colour, n (u32), n times src and dst
+    TRACE_END_FRAME
+};
+
+///
+/// \brief Writes the draw commands of flushed frames to a trace file
+///
+/// The trace is written by the thread flushing the command buffers, after
+/// the deferred tasks of a frame ran and before its commands are sorted.
+/// Textures are not captured, only their id and size.
+///
+class RenderTrace {
+  public:
+    ~RenderTrace();
+
+    ///
+    /// \brief Starts a capture, an ongoing one is closed first
+    /// \param path trace file path
+    /// \param frames number of frames to capture
+    /// \return false if the file could not be opened
+    ///
+    bool open(const std::string &path, int frames);
+
+    /// Checks if frames are being captured
+    [[nodiscard]] bool isCapturing() const;
+
+    void beginFrame(bool clear, SDL_Color clear_color, int camera_x,
+                    int camera_y, int screen_layer);
+    void points(int layer, SDL_Color color, const SDL_Point *points, int n);
+    void rects(int layer, SDL_Color color, const SDL_Rect *rects, int n);
+    void triangles(int layer, SDL_Color color, const SDL_Point *vertices,
+                   int n_vertices, const int *indices, int n_indices);
+    void copy(int layer, uint32_t texture, int texture_w, int texture_h,
+              const SDL_Rect &dst);
+    /// Starts a quad batch, followed by n calls to quadRects()
+    void quads(int layer, uint32_t texture, int texture_w, int texture_h,
+               SDL_Color color, int n);
+    void quadRects(const SDL_Rect &src, const SDL_Rect &dst);
+
+    ///
+    /// \brief Ends a frame, the file is closed after the last frame
+    ///
+    void endFrame();
+
+  private:
+    void close_();
+    void write_(const void *data, size_t size);
+    void writeU8_(uint8_t value);
+    void writeU32_(uint32_t value);
+    void writeColor_(SDL_Color color);
+    void writeRect_(const SDL_Rect &rect);
+
+    FILE *file_ = nullptr;
+    std::string path_;
+    int frames_left_ = 0;
+    int frames_ = 0;
+};
+
+///
+/// \brief Loads a render trace and records its frames into a command buffer
+///
+class RenderTraceReader {
+  public:
+    ///
+    /// \brief Texture referenced by the trace
+    ///
+    struct Texture {
+        TextureSlot::Ptr slot;
+        int w;
+        int h;
+    };
+
+    ///
+    /// \brief Reads and validates a trace file
+    /// \param path trace file path
+    /// \return false if the file is missing or malformed
+    ///
+    bool load(const std::string &path);
+
+    /// Number of complete frames in the trace
+    [[nodiscard]] size_t getFrames() const;
+
+    ///
+    /// \brief Gets the textures referenced by the trace, their slots are
+    /// empty until filled by the caller
+    ///
+    std::map<uint32_t, Texture> &getTextures();
+
+    ///
+    /// \brief Records the commands of a frame
+    /// \param frame frame index
+    /// \param buffer buffer to record into
+    ///
+    void record(size_t frame, RenderCommandBuffer &buffer);
+
+  private:
+    ///
+    /// \brief Decodes or skips a frame, starting after its TRACE_FRAME type
+    /// \return false if the data is malformed
+    ///
+    bool decode_(size_t &pos, RenderCommandBuffer *buffer);
+
+    bool read_(size_t &pos, void *out, size_t size) const;
+
+    std::vector<uint8_t> data_;
+    std::vector<size_t> frames_; // offsets of the frame records
+    std::map<uint32_t, Texture> textures_;
+
+    // Decoding scratch space
+    std::vector<SDL_Point> points_;
+    std::vector<SDL_Rect> rects_;
+    std::vector<SDL_Rect> src_;
+    std::vector<int> indices_;
+};
+
+#endif // RENDERTRACE_H
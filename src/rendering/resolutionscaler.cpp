@@ -0,0 +1,96 @@
+#include "resolutionscaler.h"
+#include "../blaster.h"
+#include <algorithm>
+#include <cmath>
+
+// Scale change per adjustment
+static const double SCALE_STEP = 0.05;
+
+// Mean frame time below which the scale is raised, relative to the target
+static const double SCALE_UP_HEADROOM = 0.8;
+
+void ResolutionScaler::configure(double min_scale, double max_scale,
+                                 double target_ms) {
+    max_scale_ = std::clamp(max_scale, 0.1, 1.0);
+    min_scale_ = std::clamp(min_scale, 0.1, max_scale_);
+    target_ms_ = target_ms > 0.0 ? target_ms : TICKS_PER_FRAME;
+    scale_ = max_scale_;
+}
+
+void ResolutionScaler::init(SDL_Renderer *renderer,
+                            RenderCommandBuffer &buffer, double scale_x,
+                            double scale_y) {
+    if (SDL_GetRendererOutputSize(renderer, &output_w_, &output_h_) < 0) {
+        LOG("Dynamic resolution disabled, no output size: %s",
+            SDL_GetError());
+        return;
+    }
+
+    screen_scale_x_ = scale_x;
+    screen_scale_y_ = scale_y;
+    target_.reset(new TextureSlot);
+    enabled_ = true;
+
+    int w = static_cast<int>(std::ceil(output_w_ * max_scale_));
+    int h = static_cast<int>(std::ceil(output_h_ * max_scale_));
+    TextureSlot::Ptr slot = target_;
+    buffer.defer([slot, w, h](SDL_Renderer *renderer) {
+        slot->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                          SDL_TEXTUREACCESS_TARGET, w, h);
+        if (slot->texture == nullptr) {
+            LOG("Creating the resolution target failed: %s", SDL_GetError());
+            return;
+        }
+        // The frame is cleared with alpha 0 inside the target, it has to
+        // replace the stale screen contents instead of blending over them
+        SDL_SetTextureBlendMode(slot->texture, SDL_BLENDMODE_NONE);
+    });
+
+    LOG("Dynamic resolution between %.2f and %.2f of %dx%d, target %.1f ms",
+        min_scale_, max_scale_, output_w_, output_h_, target_ms_);
+}
+
+void ResolutionScaler::update(double frame_ms) {
+    if (!enabled_)
+        return;
+
+    window_ms_ += frame_ms;
+    if (++window_frames_ < WINDOW)
+        return;
+
+    double mean = window_ms_ / window_frames_;
+    window_ms_ = 0.0;
+    window_frames_ = 0;
+
+    double scale = scale_;
+    if (mean > target_ms_)
+        scale = std::max(min_scale_, scale_ - SCALE_STEP);
+    else if (mean < target_ms_ * SCALE_UP_HEADROOM)
+        scale = std::min(max_scale_, scale_ + SCALE_STEP);
+
+#if DEBUG_DYNAMIC_RESOLUTION
+    if (scale != scale_)
+        LOG("Resolution scale %.2f -> %.2f, mean frame %.2f ms", scale_,
+            scale, mean);
+#endif
+    scale_ = scale;
+}
+
+void ResolutionScaler::apply(RenderCommandBuffer &buffer) const {
+    if (!enabled_)
+        return;
+
+    ScaledTarget target;
+    target.texture = target_;
+    target.scale_x = static_cast<float>(screen_scale_x_ * scale_);
+    target.scale_y = static_cast<float>(screen_scale_y_ * scale_);
+    target.src = SDL_Rect{0, 0,
+                          std::max(1, static_cast<int>(output_w_ * scale_)),
+                          std::max(1, static_cast<int>(output_h_ * scale_))};
+    target.native_layer = HUD_RENDER_LAYER_IDX;
+    buffer.setScaledTarget(target);
+}
+
+double ResolutionScaler::getScale() const { return enabled_ ? scale_ : 1.0; }
+
+bool ResolutionScaler::isEnabled() const { return enabled_; }
@@ -0,0 +1,81 @@
+#ifndef RESOLUTIONSCALER_H
+#define RESOLUTIONSCALER_H
+
+#include "../blaster.h"
+#include "rendercommandbuffer.h"
+#include "SDL2/SDL.h"
+
+///
+/// \brief Frame-time driven dynamic resolution
+///
+/// The world layers are rendered into a target texture and stretched over
+/// the screen, the HUD layers stay at native resolution. The share of the
+/// target used is the resolution scale. It is lowered in steps while the
+/// mean frame time over the last WINDOW frames is above the target frame
+/// time and raised again once there is enough headroom.
+///
+/// The target is allocated once at the maximum scale, changing the scale
+/// only changes the part of it being drawn to.
+///
+class ResolutionScaler {
+  public:
+    /// Frames averaged per adjustment
+    static const int WINDOW = 30;
+
+    ///
+    /// \brief Sets the scaling bounds
+    /// \param min_scale lowest resolution scale
+    /// \param max_scale highest resolution scale, the start value
+    /// \param target_ms frame time to hold
+    ///
+    void configure(double min_scale, double max_scale, double target_ms);
+
+    ///
+    /// \brief Enables dynamic resolution and schedules the creation of the
+    /// render target
+    /// \param renderer renderer, only queried for its output size
+    /// \param buffer command buffer the texture creation is deferred to
+    /// \param scale_x render scale of the screen
+    /// \param scale_y render scale of the screen
+    ///
+    void init(SDL_Renderer *renderer, RenderCommandBuffer &buffer,
+              double scale_x, double scale_y);
+
+    ///
+    /// \brief Adds a frame time sample and adjusts the scale once a window
+    /// is complete
+    /// \param frame_ms duration of the last frame in ms
+    ///
+    void update(double frame_ms);
+
+    ///
+    /// \brief Makes a frame render through the target, no-op unless enabled
+    /// \param buffer command buffer of the frame
+    ///
+    void apply(RenderCommandBuffer &buffer) const;
+
+    /// Current resolution scale, 1 unless enabled
+    [[nodiscard]] double getScale() const;
+
+    /// Checks if dynamic resolution is enabled
+    [[nodiscard]] bool isEnabled() const;
+
+  private:
+    TextureSlot::Ptr target_;
+    bool enabled_ = false;
+    double min_scale_ = 0.5;
+    double max_scale_ = 1.0;
+    double target_ms_ = TICKS_PER_FRAME;
+    double scale_ = 1.0;
+
+    // Screen size in pixels and its render scale
+    int output_w_ = 0;
+    int output_h_ = 0;
+    double screen_scale_x_ = 1.0;
+    double screen_scale_y_ = 1.0;
+
+    double window_ms_ = 0.0;
+    int window_frames_ = 0;
+};
+
+#endif // RESOLUTIONSCALER_H
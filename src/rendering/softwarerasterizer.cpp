@@ -0,0 +1,181 @@
+#include "softwarerasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RASTER_SSE2 1
+#include <emmintrin.h>
+#else
+#define RASTER_SSE2 0
+#endif
+
+namespace {
+
+inline void fillPixels(uint32_t *dst, int n, uint32_t pixel) {
+#if RASTER_SSE2
+    __m128i v = _mm_set1_epi32(static_cast<int>(pixel));
+    for (; n >= 4; n -= 4, dst += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), v);
+#endif
+    for (; n > 0; n--)
+        *dst++ = pixel;
+}
+
+// x of edge (x0, y0)-(x1, y1) at height y, the edge must not be horizontal
+inline float edgeX(float x0, float y0, float x1, float y1, float y) {
+    return x0 + (x1 - x0) * (y - y0) / (y1 - y0);
+}
+
+} // namespace
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height)
+    : width_(width), height_(height),
+      pixels_(static_cast<size_t>(width) * static_cast<size_t>(height), 0),
+      dirty_x0_(width), dirty_y0_(height) {}
+
+bool SoftwareRasterizer::begin(SDL_Renderer *renderer) {
+    if (failed_)
+        return false;
+    if (texture_)
+        return true;
+
+    texture_ = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                 SDL_TEXTUREACCESS_STREAMING, width_, height_);
+    if (texture_ == nullptr) {
+        LOG("Software rasterizer disabled, no streaming texture: %s",
+            SDL_GetError());
+        failed_ = true;
+        return false;
+    }
+    SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+    LOG("Software rasterizer drawing at %dx%d", width_, height_);
+    return true;
+}
+
+uint32_t SoftwareRasterizer::pixel_(uint32_t color) {
+    return 0xff000000u | (color >> 8);
+}
+
+void SoftwareRasterizer::touch_(int x0, int y0, int x1, int y1) {
+    dirty_x0_ = std::min(dirty_x0_, x0);
+    dirty_y0_ = std::min(dirty_y0_, y0);
+    dirty_x1_ = std::max(dirty_x1_, x1);
+    dirty_y1_ = std::max(dirty_y1_, y1);
+}
+
+void SoftwareRasterizer::span_(int y, int x0, int x1, uint32_t pixel) {
+    if (y < 0 || y >= height_)
+        return;
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, width_);
+    if (x0 >= x1)
+        return;
+
+    fillPixels(&pixels_[static_cast<size_t>(y) * width_ + x0], x1 - x0,
+               pixel);
+    touch_(x0, y, x1, y + 1);
+}
+
+void SoftwareRasterizer::points(uint32_t color, const SDL_Point *points,
+                                size_t n, int offset_x, int offset_y) {
+    uint32_t pixel = pixel_(color);
+    for (size_t i = 0; i < n; i++) {
+        int x = points[i].x + offset_x;
+        int y = points[i].y + offset_y;
+        if (x < 0 || x >= width_ || y < 0 || y >= height_)
+            continue;
+        pixels_[static_cast<size_t>(y) * width_ + x] = pixel;
+        touch_(x, y, x + 1, y + 1);
+    }
+}
+
+void SoftwareRasterizer::rects(uint32_t color, const SDL_Rect *rects,
+                               size_t n, int offset_x, int offset_y) {
+    uint32_t pixel = pixel_(color);
+    for (size_t i = 0; i < n; i++) {
+        int x = rects[i].x + offset_x;
+        int y0 = std::max(rects[i].y + offset_y, 0);
+        int y1 = std::min(rects[i].y + offset_y + rects[i].h, height_);
+        for (int y = y0; y < y1; y++)
+            span_(y, x, x + rects[i].w, pixel);
+    }
+}
+
+#if HAS_RENDER_GEOMETRY
+void SoftwareRasterizer::triangles(const SDL_Vertex *vertices,
+                                   const int *indices, size_t n_indices,
+                                   int offset_x, int offset_y) {
+    if (n_indices < 3)
+        return;
+    SDL_Color c = vertices[indices[0]].color;
+    uint32_t pixel = pixel_((static_cast<uint32_t>(c.r) << 24) |
+                            (static_cast<uint32_t>(c.g) << 16) |
+                            (static_cast<uint32_t>(c.b) << 8) | c.a);
+
+    for (size_t t = 0; t + 2 < n_indices; t += 3) {
+        SDL_FPoint v[3];
+        for (int k = 0; k < 3; k++) {
+            v[k] = vertices[indices[t + k]].position;
+            v[k].x += static_cast<float>(offset_x);
+            v[k].y += static_cast<float>(offset_y);
+        }
+        std::sort(v, v + 3, [](const SDL_FPoint &a, const SDL_FPoint &b) {
+            return a.y < b.y;
+        });
+
+        // Rows whose pixel centres lie within the triangle, each covering
+        // the pixel centres between the long edge and one of the short ones
+        int first = std::max(static_cast<int>(std::ceil(v[0].y - 0.5f)), 0);
+        int last = std::min(static_cast<int>(std::ceil(v[2].y - 0.5f)),
+                            height_);
+        for (int y = first; y < last; y++) {
+            float yc = static_cast<float>(y) + 0.5f;
+            float xa = edgeX(v[0].x, v[0].y, v[2].x, v[2].y, yc);
+            float xb = yc < v[1].y
+                           ? edgeX(v[0].x, v[0].y, v[1].x, v[1].y, yc)
+                           : edgeX(v[1].x, v[1].y, v[2].x, v[2].y, yc);
+            if (xa > xb)
+                std::swap(xa, xb);
+            span_(y, static_cast<int>(std::ceil(xa - 0.5f)),
+                  static_cast<int>(std::ceil(xb - 0.5f)), pixel);
+        }
+    }
+}
+#endif
+
+int SoftwareRasterizer::resolve(SDL_Renderer *renderer, int origin_x,
+                                int origin_y) {
+    if (dirty_x0_ >= dirty_x1_ || !texture_)
+        return 0;
+
+    SDL_Rect dirty{dirty_x0_, dirty_y0_, dirty_x1_ - dirty_x0_,
+                   dirty_y1_ - dirty_y0_};
+    uint32_t *first = &pixels_[static_cast<size_t>(dirty.y) * width_ +
+                               dirty.x];
+
+    // Only the dirty region is uploaded and cleared again
+    int draw_calls = 0;
+    if (SDL_UpdateTexture(texture_, &dirty, first,
+                          width_ * static_cast<int>(sizeof(uint32_t))) == 0) {
+        SDL_Rect dst{dirty.x + origin_x, dirty.y + origin_y, dirty.w,
+                     dirty.h};
+        SDL_RenderCopy(renderer, texture_, &dirty, &dst);
+        draw_calls = 1;
+    } else {
+        LOG("Uploading the software framebuffer failed, falling back to "
+            "the renderer: %s",
+            SDL_GetError());
+        failed_ = true;
+    }
+
+    for (int y = 0; y < dirty.h; y++)
+        fillPixels(first + static_cast<size_t>(y) * width_, dirty.w, 0);
+
+    dirty_x0_ = width_;
+    dirty_y0_ = height_;
+    dirty_x1_ = 0;
+    dirty_y1_ = 0;
+    return draw_calls;
+}
@@ -0,0 +1,123 @@
+#ifndef SOFTWARERASTERIZER_H
+#define SOFTWARERASTERIZER_H
+
+#include "../blaster.h"
+#include "SDL2/SDL.h"
+#include "rendercommandbuffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+///
+/// \brief CPU rasterizer for the untextured primitives of a frame
+///
+/// Points, rectangles and triangles are drawn into a framebuffer in memory
+/// at the game resolution. Only the dirty part of the framebuffer is
+/// uploaded to a streaming texture and drawn over the frame, so the cost of
+/// the renderer is one upload and one copy however many primitives were
+/// drawn. Horizontal spans are filled four pixels at a time with SSE2 where
+/// available.
+///
+/// Pixels are written without blending, like the renderer draws with
+/// SDL_BLENDMODE_NONE. Pixels not drawn stay transparent.
+///
+/// The rasterizer belongs to the thread flushing the command buffers. Its
+/// texture is freed together with the renderer.
+///
+class SoftwareRasterizer {
+  public:
+    ///
+    /// \brief Creates the framebuffer
+    /// \param width framebuffer width, in render coordinates
+    /// \param height framebuffer height, in render coordinates
+    ///
+    SoftwareRasterizer(int width, int height);
+
+    SoftwareRasterizer(const SoftwareRasterizer &) = delete;
+    SoftwareRasterizer &operator=(const SoftwareRasterizer &) = delete;
+
+    ///
+    /// \brief Creates the streaming texture on first use
+    /// \param renderer renderer drawing the frame
+    /// \return false if the texture is not available, the primitives are
+    /// then drawn by the renderer
+    ///
+    bool begin(SDL_Renderer *renderer);
+
+    ///
+    /// \brief Draws points
+    /// \param color packed RGBA colour
+    /// \param points points to draw
+    /// \param n number of points
+    /// \param offset_x x offset added to every point
+    /// \param offset_y y offset added to every point
+    ///
+    void points(uint32_t color, const SDL_Point *points, size_t n,
+                int offset_x, int offset_y);
+
+    ///
+    /// \brief Fills rectangles
+    /// \param color packed RGBA colour
+    /// \param rects rectangles to fill
+    /// \param n number of rectangles
+    /// \param offset_x x offset added to every rectangle
+    /// \param offset_y y offset added to every rectangle
+    ///
+    void rects(uint32_t color, const SDL_Rect *rects, size_t n, int offset_x,
+               int offset_y);
+
+#if HAS_RENDER_GEOMETRY
+    ///
+    /// \brief Fills indexed triangles with the colour of their first vertex
+    /// \param vertices triangle vertices
+    /// \param indices three vertex indices per triangle
+    /// \param n_indices number of indices
+    /// \param offset_x x offset added to every vertex
+    /// \param offset_y y offset added to every vertex
+    ///
+    void triangles(const SDL_Vertex *vertices, const int *indices,
+                   size_t n_indices, int offset_x, int offset_y);
+#endif
+
+    ///
+    /// \brief Uploads what was drawn since the last resolve, draws it with
+    /// the renderer and clears the framebuffer
+    /// \param renderer renderer drawing the frame
+    /// \param origin_x where the framebuffer origin is in the current
+    /// viewport
+    /// \param origin_y where the framebuffer origin is in the current
+    /// viewport
+    /// \return number of draw calls issued, 0 if nothing was drawn
+    ///
+    int resolve(SDL_Renderer *renderer, int origin_x, int origin_y);
+
+  private:
+    ///
+    /// \brief Fills pixels [x0, x1) of row y, clipped to the framebuffer
+    ///
+    void span_(int y, int x0, int x1, uint32_t pixel);
+
+    ///
+    /// \brief Grows the dirty region by a clipped rectangle
+    ///
+    void touch_(int x0, int y0, int x1, int y1);
+
+    ///
+    /// \brief Converts a packed RGBA colour to an opaque ARGB8888 pixel
+    ///
+    static uint32_t pixel_(uint32_t color);
+
+    int width_;
+    int height_;
+    std::vector<uint32_t> pixels_;
+    SDL_Texture *texture_ = nullptr;
+    bool failed_ = false;
+
+    // Dirty region since the last resolve, empty while x0 >= x1
+    int dirty_x0_;
+    int dirty_y0_;
+    int dirty_x1_ = 0;
+    int dirty_y1_ = 0;
+};
+
+#endif // SOFTWARERASTERIZER_H
@@ -0,0 +1,83 @@
+#include "workerpool.h"
+
+WorkerPool::WorkerPool(int n_workers) {
+    if (n_workers < 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        n_workers = hw > 1 ? static_cast<int>(hw) - 1 : 0;
+    }
+
+    workers_.reserve(n_workers);
+    for (int i = 0; i < n_workers; i++)
+        workers_.emplace_back(&WorkerPool::workerLoop_, this);
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    job_cv_.notify_all();
+    for (auto &t : workers_)
+        t.join();
+}
+
+size_t WorkerPool::getWorkerCount() const { return workers_.size(); }
+
+void WorkerPool::run_(size_t n_chunks, JobFn fn, void *ctx) {
+    if (n_chunks == 0)
+        return;
+
+    // Not worth waking up the workers for a single chunk
+    if (workers_.empty() || n_chunks == 1) {
+        for (size_t i = 0; i < n_chunks; i++)
+            fn(ctx, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn_ = fn;
+        ctx_ = ctx;
+        n_chunks_ = n_chunks;
+        next_chunk_.store(0, std::memory_order_relaxed);
+        busy_ = workers_.size();
+        generation_++;
+    }
+    job_cv_.notify_all();
+
+    // The calling thread works on the job as well
+    drainChunks_();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return busy_ == 0; });
+    fn_ = nullptr;
+    ctx_ = nullptr;
+}
+
+void WorkerPool::drainChunks_() {
+    size_t chunk;
+    while ((chunk = next_chunk_.fetch_add(1, std::memory_order_relaxed)) <
+           n_chunks_)
+        fn_(ctx_, chunk);
+}
+
+void WorkerPool::workerLoop_() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+        }
+
+        drainChunks_();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_ == 0)
+                done_cv_.notify_one();
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+///
+/// \brief Fixed size pool of worker threads for data parallel loops
+///
+/// parallelFor() splits a job into chunks which are claimed by the workers
+/// and the calling thread until all chunks are done. The call blocks until
+/// the whole job has finished, so jobs may reference stack data of the
+/// caller. Only one job runs at a time and jobs must not be submitted from
+/// inside a job.
+///
+class WorkerPool {
+  public:
+    ///
+    /// \brief Starts the worker threads
+    /// \param n_workers number of worker threads, negative for one less than
+    /// the number of hardware threads. With zero workers jobs run on the
+    /// calling thread.
+    ///
+    explicit WorkerPool(int n_workers = -1);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    ///
+    /// \brief Runs fn(chunk) for every chunk in [0, n_chunks) in parallel
+    /// \param n_chunks number of chunks
+    /// \param fn callable taking the chunk index
+    ///
+    template <typename Fn> void parallelFor(size_t n_chunks, Fn &&fn) {
+        auto call = [](void *ctx, size_t chunk) {
+            (*static_cast<std::remove_reference_t<Fn> *>(ctx))(chunk);
+        };
+        run_(n_chunks, call, &fn);
+    }
+
+    /// Number of worker threads, not counting the calling thread
+    [[nodiscard]] size_t getWorkerCount() const;
+
+  private:
+    typedef void (*JobFn)(void *ctx, size_t chunk);
+
+    void run_(size_t n_chunks, JobFn fn, void *ctx);
+    void workerLoop_();
+    void drainChunks_();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable job_cv_;
+    std::condition_variable done_cv_;
+
+    // Current job, guarded by mutex_ except for the chunk counter
+    JobFn fn_ = nullptr;
+    void *ctx_ = nullptr;
+    size_t n_chunks_ = 0;
+    std::atomic<size_t> next_chunk_{0};
+    uint64_t generation_ = 0;
+    size_t busy_ = 0;
+    bool stop_ = false;
+};
+
+#endif // WORKERPOOL_H
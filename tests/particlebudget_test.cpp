@@ -0,0 +1,68 @@
+// Checks the grants of the particle budget governor. Returns non-zero if a
+// check fails, run by ctest or with make test.
+#include "../src/game/particlebudget.h"
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+
+#define CHECK_EQ(actual, expected)                                             \
+    do {                                                                       \
+        size_t a_ = (actual);                                                  \
+        size_t e_ = (expected);                                                \
+        if (a_ != e_) {                                                        \
+            printf("%s:%d: %s is %zu, expected %zu\n", __FILE__, __LINE__,     \
+                   #actual, a_, e_);                                           \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+// With headroom everything is granted, on screen or not
+static void fullScale() {
+    ParticleBudget budget(1000, 1000);
+    budget.setTargetFrameTime(16.0);
+    budget.beginFrame(10.0, 0);
+
+    CHECK_EQ(budget.grant(100, true), 100);
+    CHECK_EQ(budget.grant(100, false), 100);
+    CHECK_EQ(budget.getMetrics().dropped, 0);
+}
+
+// Over the target frame time off-screen emitters get a smaller share
+static void reducedScale() {
+    ParticleBudget budget(1000, 1000);
+    budget.setTargetFrameTime(16.0);
+    budget.beginFrame(32.0, 0);
+
+    size_t on_screen = budget.grant(100, true);
+    size_t off_screen = budget.grant(100, false);
+    if (on_screen >= 100 || off_screen >= on_screen) {
+        printf("%s:%d: reduced scale granted %zu on and %zu off screen\n",
+               __FILE__, __LINE__, on_screen, off_screen);
+        failures++;
+    }
+}
+
+// A binding cap makes the budget tight even at full scale
+static void bindingCap() {
+    ParticleBudget budget(1000, 50);
+    budget.setTargetFrameTime(16.0);
+    budget.beginFrame(10.0, 0);
+
+    CHECK_EQ(budget.grant(100, false), 25);
+    CHECK_EQ(budget.grant(100, true), 25);
+    CHECK_EQ(budget.grant(100, true), 0);
+}
+
+int main() {
+    fullScale();
+    reducedScale();
+    bindingCap();
+
+    if (failures) {
+        printf("%d particle budget checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("Particle budget checks passed\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+// Checks how polygons move when rotated. Returns non-zero if a check fails,
+// run by ctest or with make test.
+#include "../src/game/graphics.h"
+#include "../src/rendering/renderengine.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static int failures = 0;
+
+// Outline coordinates are truncated to integers, allow one pixel either way
+#define CHECK_NEAR(actual, expected)                                           \
+    do {                                                                       \
+        int a_ = (actual);                                                     \
+        int e_ = (expected);                                                   \
+        if (std::abs(a_ - e_) > 1) {                                           \
+            printf("%s:%d: %s is %d, expected %d\n", __FILE__, __LINE__,       \
+                   #actual, a_, e_);                                           \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+// Diamond with its center at (100, 100)
+static std::vector<SDL_Point> diamond() {
+    return {{110, 100}, {100, 110}, {90, 100}, {100, 90}, {110, 100}};
+}
+
+// Rotating around another point moves the center along with the outline
+static void rotateAroundOrigin(RenderEngine *engine) {
+    Polygon polygon(engine, diamond(), 100, 100);
+    polygon.rotate(M_PI / 2, 50, 100);
+
+    CHECK_NEAR(polygon.x, 50);
+    CHECK_NEAR(polygon.y, 150);
+    SDL_Point *outline = polygon.getOutline();
+    CHECK_NEAR(outline[0].x, 50);
+    CHECK_NEAR(outline[0].y, 160);
+    CHECK_NEAR(outline[1].x, 40);
+    CHECK_NEAR(outline[1].y, 150);
+    CHECK_NEAR(outline[2].x, 50);
+    CHECK_NEAR(outline[2].y, 140);
+    CHECK_NEAR(polygon.getMinX(), 40);
+    CHECK_NEAR(polygon.getMaxX(), 60);
+    CHECK_NEAR(polygon.getMinY(), 140);
+    CHECK_NEAR(polygon.getMaxY(), 160);
+
+    // Moving afterwards keeps the rotation
+    polygon.move(10, -10);
+    CHECK_NEAR(polygon.x, 60);
+    CHECK_NEAR(polygon.y, 140);
+    CHECK_NEAR(polygon.getOutline()[0].x, 60);
+    CHECK_NEAR(polygon.getOutline()[0].y, 150);
+}
+
+// Four quarter turns around the same point return to the start
+static void fullTurnAroundOrigin(RenderEngine *engine) {
+    Polygon polygon(engine, diamond(), 100, 100);
+    for (int i = 0; i < 4; i++)
+        polygon.rotate(M_PI / 2, 0, 0);
+
+    CHECK_NEAR(polygon.x, 100);
+    CHECK_NEAR(polygon.y, 100);
+    std::vector<SDL_Point> start = diamond();
+    SDL_Point *outline = polygon.getOutline();
+    for (int i = 0; i < polygon.points; i++) {
+        CHECK_NEAR(outline[i].x, start[i].x);
+        CHECK_NEAR(outline[i].y, start[i].y);
+    }
+}
+
+// Rotating around the center is the same as rotating in place
+static void rotateAroundCenter(RenderEngine *engine) {
+    Polygon around(engine, diamond(), 100, 100);
+    Polygon in_place(engine, diamond(), 100, 100);
+    around.rotate(0.3, 100, 100);
+    in_place.rotate(0.3);
+
+    CHECK_NEAR(around.x, 100);
+    CHECK_NEAR(around.y, 100);
+    SDL_Point *a = around.getOutline();
+    SDL_Point *b = in_place.getOutline();
+    for (int i = 0; i < around.points; i++) {
+        CHECK_NEAR(a[i].x, b[i].x);
+        CHECK_NEAR(a[i].y, b[i].y);
+    }
+}
+
+int main() {
+    // Nothing is drawn, the engine only keeps the list of render objects
+    RenderEngine engine(nullptr);
+
+    rotateAroundOrigin(&engine);
+    fullTurnAroundOrigin(&engine);
+    rotateAroundCenter(&engine);
+
+    if (failures) {
+        printf("%d polygon checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    printf("Polygon checks passed\n");
+    return EXIT_SUCCESS;
+}
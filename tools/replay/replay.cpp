@@ -0,0 +1,161 @@
+// Replays a render trace captured with -trace or F9 as fast as possible and
+// reports the cost of flushing and presenting its frames. Only the render
+// path is timed, the game simulation is not part of a trace.
+#include "../../src/blaster.h"
+#include "../../src/rendering/rendercommandbuffer.h"
+#include "../../src/rendering/rendertrace.h"
+#include "../../src/rendering/softwarerasterizer.h"
+#include "SDL2/SDL.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+double g_timescale = 1.0;
+
+static const char *const replay_help_str = R"HELP(
+Usage: replay TRACE OPTION...
+Optional arguments:
+    -loops <n>,     Replay the trace n times, default 1
+    -headless,      Render offscreen with the software renderer
+    -raster,        Draw points, lines and fills with the CPU rasterizer
+    -width <w>,     Output width, default 1920
+    -height <h>,    Output height, default 1080
+    -h,             Print this help
+)HELP";
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("%s", replay_help_str);
+        return EXIT_FAILURE;
+    }
+
+    const char *path = argv[1];
+    int loops = 1;
+    bool headless = false;
+    bool raster = false;
+    int width = SCREEN_RES_W;
+    int height = SCREEN_RES_H;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "-loops") == 0 && argc > i + 1)
+            loops = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "-headless") == 0)
+            headless = true;
+        else if (strcmp(argv[i], "-raster") == 0)
+            raster = true;
+        else if (strcmp(argv[i], "-width") == 0 && argc > i + 1)
+            width = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-height") == 0 && argc > i + 1)
+            height = atoi(argv[++i]);
+        else {
+            printf("%s", replay_help_str);
+            return EXIT_FAILURE;
+        }
+    }
+
+    RenderTraceReader trace;
+    if (!trace.load(path))
+        ERROR("Could not load render trace %s", path);
+    LOG("Loaded %zu frames from %s", trace.getFrames(), path);
+
+    // Same renderer setup as the game, without vsync
+    if (headless)
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+        ERROR("SDL could not initialize! SDL Error: %s", SDL_GetError());
+    SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
+
+    SDL_Window *window = nullptr;
+    SDL_Surface *framebuffer = nullptr;
+    SDL_Renderer *renderer = nullptr;
+    if (headless) {
+        framebuffer = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32,
+                                                     SDL_PIXELFORMAT_ARGB8888);
+        if (framebuffer)
+            renderer = SDL_CreateSoftwareRenderer(framebuffer);
+    } else {
+        window = SDL_CreateWindow("Space-Blaster trace replay",
+                                  SDL_WINDOWPOS_UNDEFINED,
+                                  SDL_WINDOWPOS_UNDEFINED, width, height,
+                                  SDL_WINDOW_SHOWN);
+        if (window)
+            renderer =
+                SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    }
+    if (renderer == nullptr)
+        ERROR("Renderer could not be created! SDL Error: %s", SDL_GetError());
+    SDL_RenderSetScale(renderer, static_cast<float>(width) / SCREEN_RES_W,
+                       static_cast<float>(height) / SCREEN_RES_H);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    // Traces carry no texture contents, draw white textures of the same size
+    for (auto &entry : trace.getTextures()) {
+        RenderTraceReader::Texture &texture = entry.second;
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(
+            0, std::max(1, texture.w), std::max(1, texture.h), 32,
+            SDL_PIXELFORMAT_RGBA32);
+        if (!surface)
+            continue;
+        SDL_FillRect(surface, nullptr, 0xffffffff);
+        texture.slot->texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (texture.slot->texture)
+            SDL_SetTextureBlendMode(texture.slot->texture,
+                                    SDL_BLENDMODE_BLEND);
+        SDL_FreeSurface(surface);
+    }
+
+    RenderCommandBuffer buffer;
+    SoftwareRasterizer rasterizer(SCREEN_RES_W, SCREEN_RES_H);
+    if (raster)
+        buffer.setRasterizer(&rasterizer);
+    double freq = static_cast<double>(SDL_GetPerformanceFrequency());
+    double total_ms = 0.0;
+    double worst_ms = 0.0;
+    long long draw_calls = 0;
+    long long state_changes = 0;
+    size_t frames = 0;
+    bool quit = false;
+    for (int loop = 0; loop < loops && !quit; loop++) {
+        for (size_t f = 0; f < trace.getFrames() && !quit; f++) {
+            SDL_Event e;
+            while (SDL_PollEvent(&e) != 0)
+                if (e.type == SDL_QUIT)
+                    quit = true;
+
+            // Decoding the trace is not part of the measured render cost
+            trace.record(f, buffer);
+            Uint64 start = SDL_GetPerformanceCounter();
+            buffer.flush(renderer);
+            SDL_RenderPresent(renderer);
+            double ms = static_cast<double>(SDL_GetPerformanceCounter() -
+                                            start) *
+                        1000.0 / freq;
+
+            total_ms += ms;
+            worst_ms = std::max(worst_ms, ms);
+            draw_calls += buffer.getStats().draw_calls;
+            state_changes += buffer.getStats().state_changes;
+            frames++;
+        }
+    }
+
+    if (frames > 0) {
+        LOG("%zu frames, %.3f ms per frame, worst %.3f ms", frames,
+            total_ms / frames, worst_ms);
+        LOG("%.1f draw calls, %.1f state changes per frame",
+            static_cast<double>(draw_calls) / frames,
+            static_cast<double>(state_changes) / frames);
+    }
+
+    for (auto &entry : trace.getTextures())
+        if (entry.second.slot->texture)
+            SDL_DestroyTexture(entry.second.slot->texture);
+    SDL_DestroyRenderer(renderer);
+    if (window)
+        SDL_DestroyWindow(window);
+    if (framebuffer)
+        SDL_FreeSurface(framebuffer);
+    SDL_Quit();
+    return EXIT_SUCCESS;
+}